@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "backgroundworker_p.h"
+#include "error.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include "logging.h"
+
+using namespace Firfuorida;
+
+BackgroundConnection::BackgroundConnection(const QSqlDatabase &db) :
+    driverName(db.driverName()),
+    databaseName(db.databaseName()),
+    hostName(db.hostName()),
+    userName(db.userName()),
+    password(db.password()),
+    connectOptions(db.connectOptions()),
+    port(db.port())
+{
+
+}
+
+QSqlDatabase BackgroundConnection::open(const QString &connectionName) const
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(driverName, connectionName);
+    db.setDatabaseName(databaseName);
+    db.setHostName(hostName);
+    db.setUserName(userName);
+    db.setPassword(password);
+    db.setConnectOptions(connectOptions);
+    db.setPort(port);
+    db.open();
+    return db;
+}
+
+void BackgroundQueue::push(BackgroundJob &&job)
+{
+    QMutexLocker locker(&m_mutex);
+    m_jobs.push_back(std::move(job));
+}
+
+bool BackgroundQueue::take(BackgroundJob &job)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_jobs.empty()) {
+        return false;
+    }
+    job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+    return true;
+}
+
+void BackgroundQueue::setError(const Error &error)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_error.type() == Error::NoError) {
+        m_error = error;
+    }
+}
+
+Error BackgroundQueue::error() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+BackgroundWorker::BackgroundWorker(const BackgroundConnection &connection, const QString &migrationsTable, int throttle, const LagThrottle &lagThrottle, const std::shared_ptr<BackgroundQueue> &queue) :
+    QThread(),
+    m_connection(connection),
+    m_connectionName(QStringLiteral("firfuorida-background-%1").arg(reinterpret_cast<quintptr>(this), 0, 16)),
+    m_migrationsTable(migrationsTable),
+    m_queue(queue),
+    m_throttle(throttle),
+    m_lagThrottle(lagThrottle)
+{
+
+}
+
+BackgroundWorker::~BackgroundWorker()
+{
+    requestInterruption();
+    wait();
+}
+
+void BackgroundWorker::run()
+{
+    {
+        QSqlDatabase db = m_connection.open(m_connectionName);
+        if (db.isOpen()) {
+            BackgroundJob job;
+            while (!isInterruptionRequested() && m_queue->take(job)) {
+                runJob(db, job);
+            }
+            db.close();
+        } else {
+            fail(Error(db.lastError(), QStringLiteral("Can not open database connection for background migrations:")));
+        }
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+    removeLagConnections();
+}
+
+bool BackgroundWorker::runJob(QSqlDatabase &db, const BackgroundJob &job)
+{
+    qCInfo(FIR_CORE, "Running background migration %s from statement %i of %i", qUtf8Printable(job.name), job.progress + 1, static_cast<int>(job.statements.size()));
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lagWait = 0;
+
+    QSqlQuery query(db);
+    QSqlQuery progress(db);
+    progress.prepare(QStringLiteral("UPDATE %1 SET progress = ? WHERE migration = ?").arg(m_migrationsTable));
+
+    for (int i = job.progress; i < job.statements.size(); ++i) {
+        if (isInterruptionRequested()) {
+            qCInfo(FIR_CORE, "Interrupted background migration %s after %i of %i statements", qUtf8Printable(job.name), i, static_cast<int>(job.statements.size()));
+            return false;
+        }
+
+        if (!query.exec(job.statements.at(i))) {
+            fail(Error(query.lastError(), QStringLiteral("Failed to execute SQL query for background migration \"%1\".").arg(job.name)));
+            qCCritical(FIR_CORE, "Failed query: %s", qUtf8Printable(query.lastQuery()));
+            return false;
+        }
+
+        progress.addBindValue(i + 1);
+        progress.addBindValue(job.name);
+        if (!progress.exec()) {
+            qCWarning(FIR_CORE) << Error(progress.lastError(), QStringLiteral("Failed to store progress of background migration \"%1\":").arg(job.name));
+        }
+
+        if (i + 1 < job.statements.size()) {
+            if (m_throttle > 0) {
+                QThread::msleep(static_cast<unsigned long>(m_throttle));
+            }
+            lagWait += m_lagThrottle.wait(db, [this]() { return isInterruptionRequested(); });
+        }
+    }
+
+    query.prepare(QStringLiteral("UPDATE %1 SET progress = NULL, execution_time = ?, lag_wait = ? WHERE migration = ?").arg(m_migrationsTable));
+    query.addBindValue(static_cast<qlonglong>(timer.elapsed()));
+    query.addBindValue(lagWait);
+    query.addBindValue(job.name);
+    if (!query.exec()) {
+        fail(Error(query.lastError(), QStringLiteral("Failed to mark background migration \"%1\" as finished:").arg(job.name)));
+        return false;
+    }
+
+    qCInfo(FIR_CORE, "Finished background migration %s", qUtf8Printable(job.name));
+
+    return true;
+}
+
+void BackgroundWorker::fail(const Error &error)
+{
+    qCCritical(FIR_CORE) << error;
+    m_queue->setError(error);
+}
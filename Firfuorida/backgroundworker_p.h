@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_BACKGROUNDWORKER_P_H
+#define FIRFUORIDA_BACKGROUNDWORKER_P_H
+
+#include "lagthrottle_p.h"
+#include "error.h"
+#include <QThread>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <deque>
+#include <memory>
+
+namespace Firfuorida {
+
+/*!
+ * \internal
+ * \brief A background migration rendered to plain SQL statements.
+ *
+ * The statements are rendered in the thread of the Migrator, so that the worker
+ * does not have to touch any Migration or Table object.
+ */
+class BackgroundJob
+{
+public:
+    QString name;
+    QStringList statements;
+    // number of statements already executed by an earlier run
+    int progress = 0;
+};
+
+/*!
+ * \internal
+ * \brief Parameters to open a new connection to the database of the Migrator.
+ *
+ * QSqlDatabase connections can only be used in the thread that created them, so the
+ * worker opens its own connection with the parameters taken from the original one.
+ */
+class BackgroundConnection
+{
+public:
+    explicit BackgroundConnection(const QSqlDatabase &db);
+
+    /*!
+     * \brief Adds and opens a new connection called \a connectionName in the current thread.
+     */
+    QSqlDatabase open(const QString &connectionName) const;
+
+    QString driverName;
+    QString databaseName;
+    QString hostName;
+    QString userName;
+    QString password;
+    QString connectOptions;
+    int port = -1;
+};
+
+/*!
+ * \internal
+ * \brief Jobs shared by all workers of a Migrator.
+ */
+class BackgroundQueue
+{
+public:
+    void push(BackgroundJob &&job);
+
+    /*!
+     * \brief Moves the next job into \a job and returns \c true, returns \c false if the queue is empty.
+     */
+    bool take(BackgroundJob &job);
+
+    /*!
+     * \brief Records the \a error of a failed job, only the first one is kept.
+     */
+    void setError(const Error &error);
+
+    /*!
+     * \brief Returns the error of the first failed job.
+     */
+    Error error() const;
+
+private:
+    mutable QMutex m_mutex;
+    std::deque<BackgroundJob> m_jobs;
+    Error m_error;
+};
+
+/*!
+ * \internal
+ * \brief Executes background migrations on its own thread and database connection.
+ *
+ * After every statement the number of executed statements is stored in the progress
+ * column of the migrations table, once all statements have been executed the progress
+ * is set to \c NULL. A job that has been interrupted or that failed keeps its progress
+ * and is resumed at the next statement by a later Migrator::migrate().
+ */
+class BackgroundWorker : public QThread
+{
+public:
+    BackgroundWorker(const BackgroundConnection &connection, const QString &migrationsTable, int throttle, const LagThrottle &lagThrottle, const std::shared_ptr<BackgroundQueue> &queue);
+    ~BackgroundWorker() override;
+
+protected:
+    void run() override;
+
+private:
+    bool runJob(QSqlDatabase &db, const BackgroundJob &job);
+    void fail(const Error &error);
+
+    const BackgroundConnection m_connection;
+    const QString m_connectionName;
+    const QString m_migrationsTable;
+    const std::shared_ptr<BackgroundQueue> m_queue;
+    const int m_throttle;
+    LagThrottle m_lagThrottle;
+};
+
+}
+
+#endif // FIRFUORIDA_BACKGROUNDWORKER_P_H
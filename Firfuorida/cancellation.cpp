@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "cancellation_p.h"
+#include "backgroundworker_p.h"
+#include "dialect_p.h"
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include "logging.h"
+
+#ifdef FIRFUORIDA_SQLITE_INTERRUPT
+#include <sqlite3.h>
+#endif
+
+using namespace Firfuorida;
+
+Cancellation::Cancellation() = default;
+
+Cancellation::~Cancellation() = default;
+
+void Cancellation::cancel(Reason reason)
+{
+    int expected = NotCancelled;
+    if (!m_reason.compare_exchange_strong(expected, reason)) {
+        return;
+    }
+    qCWarning(FIR_CORE, "%s", reason == TimedOut ? "Migration timed out, cancelling it" : "Cancelling migration");
+    interrupt();
+}
+
+void Cancellation::attach(const QSqlDatabase &db, const Dialect *dialect)
+{
+    QMutexLocker locker(&m_mutex);
+    m_attached = true;
+    registerConnection(db, dialect);
+}
+
+void Cancellation::reattach(const QSqlDatabase &db, const Dialect *dialect)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_attached) {
+        registerConnection(db, dialect);
+    }
+}
+
+void Cancellation::registerConnection(const QSqlDatabase &db, const Dialect *dialect)
+{
+    m_connection.reset();
+    m_cancelQuery.clear();
+    m_sqliteHandle = nullptr;
+
+#ifdef FIRFUORIDA_SQLITE_INTERRUPT
+    const QVariant handle = db.driver()->handle();
+    if (handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0) {
+        m_sqliteHandle = *static_cast<sqlite3 *const *>(handle.data());
+        return;
+    }
+#endif
+
+    const QString idQuery = dialect->connectionIdQuery();
+    if (idQuery.isEmpty()) {
+        return;
+    }
+    QSqlQuery q(db);
+    if (q.exec(idQuery) && q.next()) {
+        m_cancelQuery = dialect->cancelQuery(q.value(0).toString());
+        m_connection.reset(new BackgroundConnection(db));
+    } else {
+        qCWarning(FIR_CORE) << "Failed to query the connection id, running statements can not be cancelled:" << q.lastError();
+    }
+}
+
+void Cancellation::detach()
+{
+    QMutexLocker locker(&m_mutex);
+    m_attached = false;
+    m_connection.reset();
+    m_cancelQuery.clear();
+    m_sqliteHandle = nullptr;
+
+    // cleared when a run ends, so that a cancel() just before the next run is kept
+    m_reason.store(NotCancelled);
+}
+
+void Cancellation::interrupt()
+{
+    QMutexLocker locker(&m_mutex);
+
+#ifdef FIRFUORIDA_SQLITE_INTERRUPT
+    if (m_sqliteHandle) {
+        sqlite3_interrupt(static_cast<sqlite3 *>(m_sqliteHandle));
+        return;
+    }
+#endif
+
+    if (!m_connection) {
+        return;
+    }
+
+    // called from another thread, so it needs its own connection
+    const QString connectionName = QStringLiteral("firfuorida-cancel-%1").arg(reinterpret_cast<quintptr>(QThread::currentThread()), 0, 16);
+    {
+        QSqlDatabase db = m_connection->open(connectionName);
+        if (db.isOpen()) {
+            QSqlQuery q(db);
+            if (!q.exec(m_cancelQuery)) {
+                qCWarning(FIR_CORE) << "Failed to cancel the running statement:" << q.lastError();
+            }
+            db.close();
+        } else {
+            qCWarning(FIR_CORE) << "Failed to open connection to cancel the running statement:" << db.lastError();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+CancelTimer::CancelTimer(Cancellation &cancellation, int msecs) :
+    QThread(),
+    m_cancellation(cancellation),
+    m_msecs(msecs)
+{
+    if (m_msecs > 0) {
+        start();
+    }
+}
+
+CancelTimer::~CancelTimer()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_stop.wakeAll();
+    }
+    wait();
+}
+
+void CancelTimer::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopped) {
+        const qint64 remaining = m_msecs - timer.elapsed();
+        if (remaining <= 0) {
+            locker.unlock();
+            m_cancellation.cancel(Cancellation::TimedOut);
+            return;
+        }
+        m_stop.wait(&m_mutex, static_cast<unsigned long>(remaining));
+    }
+}
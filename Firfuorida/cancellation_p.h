@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_CANCELLATION_P_H
+#define FIRFUORIDA_CANCELLATION_P_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSqlDatabase>
+#include <atomic>
+#include <memory>
+
+namespace Firfuorida {
+
+class Dialect;
+class BackgroundConnection;
+
+/*!
+ * \internal
+ * \brief Cancellation state of a migration run, shared between the Migrator and other threads.
+ *
+ * The migration loop checks isCancelled() between statements. In addition cancel()
+ * interrupts the statement that is currently executed on the attached connection on
+ * the server side: MySQL and MariaDB by KILL QUERY, PostgreSQL by pg_cancel_backend()
+ * on a separate connection and SQLite by sqlite3_interrupt() on the driver handle if
+ * the library has been built with FIRFUORIDA_SQLITE_INTERRUPT.
+ */
+class Cancellation
+{
+public:
+    enum Reason : int {
+        NotCancelled = 0,
+        Cancelled,
+        TimedOut
+    };
+
+    Cancellation();
+    ~Cancellation();
+
+    /*!
+     * \brief Cancels the current run for \a reason, only the first reason is kept. Thread-safe.
+     */
+    void cancel(Reason reason = Cancelled);
+
+    Reason reason() const { return static_cast<Reason>(m_reason.load()); }
+    bool isCancelled() const { return m_reason.load() != NotCancelled; }
+
+    /*!
+     * \brief Registers \a db as the connection that executes the migrations.
+     *
+     * A cancellation that happened before is kept. Has to be called in the thread of \a db.
+     */
+    void attach(const QSqlDatabase &db, const Dialect *dialect);
+
+    /*!
+     * \brief Registers the reopened connection \a db if a connection is attached, keeping the cancellation.
+     *
+     * The server side id of the connection changes when it is reopened. Has to be called in
+     * the thread of \a db.
+     */
+    void reattach(const QSqlDatabase &db, const Dialect *dialect);
+
+    /*!
+     * \brief Unregisters the connection, waiting for a server side cancel in progress, and clears the cancellation.
+     */
+    void detach();
+
+private:
+    Q_DISABLE_COPY(Cancellation)
+    void interrupt();
+    // has to be called with m_mutex locked
+    void registerConnection(const QSqlDatabase &db, const Dialect *dialect);
+
+    std::atomic<int> m_reason{NotCancelled};
+    QMutex m_mutex;
+    std::unique_ptr<BackgroundConnection> m_connection;
+    QString m_cancelQuery;
+    void *m_sqliteHandle = nullptr;
+    bool m_attached = false;
+};
+
+/*!
+ * \internal
+ * \brief Attaches a Cancellation to a connection for the lifetime of the scope.
+ */
+class CancellationScope
+{
+public:
+    CancellationScope(Cancellation &cancellation, const QSqlDatabase &db, const Dialect *dialect) :
+        m_cancellation(cancellation)
+    {
+        m_cancellation.attach(db, dialect);
+    }
+
+    ~CancellationScope()
+    {
+        m_cancellation.detach();
+    }
+
+private:
+    Q_DISABLE_COPY(CancellationScope)
+    Cancellation &m_cancellation;
+};
+
+/*!
+ * \internal
+ * \brief Cancels a Cancellation with reason TimedOut if it has not been destroyed within the timeout.
+ *
+ * The timer runs on its own thread, as the thread of the migration is blocked while a
+ * statement is executed. A timeout of \c 0 or less does not start the thread.
+ */
+class CancelTimer : public QThread
+{
+public:
+    CancelTimer(Cancellation &cancellation, int msecs);
+    ~CancelTimer() override;
+
+protected:
+    void run() override;
+
+private:
+    Cancellation &m_cancellation;
+    QMutex m_mutex;
+    QWaitCondition m_stop;
+    const int m_msecs;
+    bool m_stopped = false;
+};
+
+}
+
+#endif // FIRFUORIDA_CANCELLATION_P_H
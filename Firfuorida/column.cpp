@@ -4,674 +4,281 @@
  */
 
 #include "column_p.h"
+#include "table_p.h"
+#include "sqlbuilder_p.h"
+#include "dialect_p.h"
 #include <QStringList>
-#include <QDate>
-#include <QTime>
-#include <QDateTime>
-#include <QBitArray>
 #include "logging.h"
-#include "table.h"
-#include "migration.h"
 
 using namespace Firfuorida;
 
-QString ColumnPrivate::typeString() const
-{
-    QString str;
-    if (dbType() == Migrator::MariaDB || dbType() == Migrator::MySQL) {
-        switch(type) {
-        case TinyInt:
-            str = QStringLiteral("TINYINT");
-            break;
-        case SmallInt:
-        case SmallSerial:
-            str = QStringLiteral("SMALLINT");
-            break;
-        case MediumInt:
-            str = QStringLiteral("MEDIUMINT");
-            break;
-        case Int:
-        case Serial:
-            str = QStringLiteral("INT");
-            break;
-        case BigInt:
-        case BigSerial:
-            str = QStringLiteral("BIGINT");
-            break;
-        case Decimal:
-            str = QStringLiteral("DECIMAL") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Numeric:
-            str = QStringLiteral("NUMERIC") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Float:
-            str = QStringLiteral("FLOAT") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Double:
-            str = QStringLiteral("DOUBLE") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Bit:
-            str = QStringLiteral("BIT") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case Date:
-            str = QStringLiteral("DATE");
-            break;
-        case DateTime:
-            str = QStringLiteral("DATETIME");
-            break;
-        case Timestamp:
-            str = QStringLiteral("TIMESTAMP");
-            break;
-        case Time:
-            str = QStringLiteral("TIME");
-            break;
-        case Year:
-            str = QStringLiteral("YEAR");
-            break;
-        case Binary:
-            str = QStringLiteral("BINARY") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case VarBinary:
-            str = QStringLiteral("VARBINARY") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case TinyBlob:
-            str = QStringLiteral("TINYBLOB");
-            break;
-        case Blob:
-            str = QStringLiteral("BLOB");
-            break;
-        case MediumBlob:
-            str = QStringLiteral("MEDIUMBLOB");
-            break;
-        case LongBlob:
-            str = QStringLiteral("LONGBLOB");
-            break;
-        case Char:
-            str = QStringLiteral("CHAR") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case VarChar:
-            str = QStringLiteral("VARCHAR") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case TinyText:
-            str = QStringLiteral("TINYTEXT");
-            break;
-        case Text:
-            str = QStringLiteral("TEXT");
-            break;
-        case MediumText:
-            str = QStringLiteral("MEDIUMTEXT");
-            break;
-        case LongText:
-            str = QStringLiteral("LONGTEXT");
-            break;
-        case Json:
-            str = QStringLiteral("JSON");
-            break;
-        case Enum:
-            str = QStringLiteral("ENUM");
-            break;
-        case Set:
-            str = QStringLiteral("SET");
-            break;
-        case Boolean:
-            str = QStringLiteral("TINYINT(1)");
-            break;
-        case Key:
-            str = QStringLiteral("KEY");
-            break;
-        case FulltextIndex:
-            str = QStringLiteral("FULLTEXT INDEX");
-            break;
-        case SpatialIndex:
-            str = QStringLiteral("SPATIAL INDEX");
-            break;
-        case PrimaryKey:
-            str = QStringLiteral("PRIMARY KEY");
-            break;
-        case UniqueKey:
-            str = QStringLiteral("UNIQUE KEY");
-            break;
-        case ForeignKey:
-            str = QStringLiteral("FOREIGN KEY");
-            break;
-        case Invalid:
-            return str;
-        }
+namespace {
 
-        if (type == Enum || type == Set) {
-            QStringList setList;
-            setList.reserve(enumSet.size());
-            const auto lst = enumSet;
-            for (const QString &part : lst) {
-                const QString _part = QLatin1Char('\'') + part + QLatin1Char('\'');
-                setList << _part;
-            }
-            str += QLatin1Char('(') + setList.join(QStringLiteral(", ")) + QLatin1Char(')');
-        }
+void appendPrecision(SqlBuilder &sql, uint precision, uint scale)
+{
+    sql << QLatin1Char('(');
+    sql.number(precision) << QLatin1Char(',');
+    sql.number(scale) << QLatin1Char(')');
+}
 
-        if (displayWidth > 0 && type < Decimal) {
-            str += QLatin1Char('(') + QString::number(displayWidth) + QLatin1Char(')');
-        }
-    } else if(dbType() == Migrator::SQLite) {
-        switch(type) {
-        case TinyInt:
-        case SmallInt:
-        case SmallSerial:
-        case MediumInt:
-        case Int:
-        case Serial:
-        case BigInt:
-        case BigSerial:
-            str = QStringLiteral("INTEGER");
-            break;
-        case Char:
-        case VarChar:
-        case TinyText:
-        case Text:
-        case MediumText:
-        case LongText:
-        case Json:
-        case Binary:
-        case VarBinary:
-            str = QStringLiteral("TEXT");
-            break;
-        case TinyBlob:
-        case Blob:
-        case MediumBlob:
-        case LongBlob:
-            str = QStringLiteral("BLOB");
-            break;
-        case Float:
-        case Double:
-            str = QStringLiteral("REAL");
-            break;
-        case Bit:
-        case Decimal:
-        case Numeric:
-        case Date:
-        case DateTime:
-        case Timestamp:
-        case Time:
-        case Year:
-        case Boolean:
-            str = QStringLiteral("NUMERIC");
-            break;
-        case Enum:
-        case Set:
-            qCWarning(FIR_CORE, "%s", "ENUM and SET data types are not supported on SQLite databases.");
-            break;
-        case Key:
-            str = QStringLiteral("KEY");
-            break;
-        case PrimaryKey:
-            str = QStringLiteral("PRIMARY KEY");
-            break;
-        case UniqueKey:
-            str = QStringLiteral("UNIQUE");
-            break;
-        case ForeignKey:
-            str = QStringLiteral("FOREIGN KEY");
-            break;
-        case FulltextIndex:
-        case SpatialIndex:
-        case Invalid:
-            return str;
-        }
-    } else if (dbType() == Migrator::PSQL) {
-        switch (type) {
-        case TinyInt:
-        case SmallInt:
-            str = QStringLiteral("SMALLINT");
-            break;
-        case SmallSerial:
-            str = QStringLiteral("SMALLSERIAL");
-            break;
-        case MediumInt:
-        case Int:
-            str = QStringLiteral("INTEGER");
-            break;
-        case Serial:
-            str = QStringLiteral("SERIAL");
-            break;
-        case BigInt:
-            str = QStringLiteral("BIGINT");
-            break;
-        case BigSerial:
-            str = QStringLiteral("BIGSERIAL");
-            break;
-        case Decimal:
-            str = QStringLiteral("DECIMAL") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Numeric:
-            str = QStringLiteral("NUMERIC") + QLatin1Char('(') + QString::number(precision) + QLatin1Char(',') + QString::number(scale) + QLatin1Char(')');
-            break;
-        case Float:
-            str = QStringLiteral("REAL");
-            break;
-        case Double:
-            str = QStringLiteral("DOUBLE PRECISION");
-            break;
-        case Bit:
-            str = QStringLiteral("BIT") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case Date:
-            str  = QStringLiteral("DATE");
-            break;
-        case DateTime:
-        case Timestamp:
-            str = QStringLiteral("TIMESTAMP");
-            break;
-        case Time:
-            str = QStringLiteral("TIME");
-            break;
-        case Binary:
-        case VarBinary:
-        case TinyBlob:
-        case Blob:
-        case MediumBlob:
-        case LongBlob:
-            str = QStringLiteral("BYTEA");
-            break;
-        case Char:
-            str = QStringLiteral("CHAR") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case VarChar:
-            str = QStringLiteral("VARCHAR") + QLatin1Char('(') + QString::number(length) + QLatin1Char(')');
-            break;
-        case TinyText:
-        case Text:
-        case MediumText:
-        case LongText:
-            str = QStringLiteral("TEXT");
-            break;
-        case Json:
-            str = QStringLiteral("JSON");
-            break;
-        case Enum:
-        case Set:
-        case Boolean:
-            str = QStringLiteral("BOOLEAN");
-            break;
-        case Key:
-        case FulltextIndex:
-        case SpatialIndex:
-        case PrimaryKey:
-        case UniqueKey:
-        case ForeignKey:
-        default:
-            break;
-        }
-    }
+void appendLength(SqlBuilder &sql, uint length)
+{
+    sql << QLatin1Char('(');
+    sql.number(length) << QLatin1Char(')');
+}
 
-    return str;
 }
 
-QString ColumnPrivate::defValString() const
+void ColumnPrivate::renderType(SqlBuilder &sql) const
 {
-    Q_Q(const Column);
+    const TypeMapping *mappings = context->dialect->typeMappings();
+    if (!mappings) {
+        return;
+    }
 
-    QString str;
+    const TypeMapping &mapping = mappings[type];
+    if (!mapping.name) {
+        return;
+    }
+
+    if (mapping.params == TypeParams::Unsupported) {
+        qCWarning(FIR_CORE, "%s data type is not supported on %s databases.", mapping.name, qUtf8Printable(dbTypeToStr()));
+        return;
+    }
+
+    sql << QLatin1String(mapping.name);
 
-    if (dbType() == Migrator::MySQL || dbType() == Migrator::MariaDB) {
-        const QString defValStr = defVal.toString();
-        if (defValStr.startsWith(QLatin1Char('(')) && defValStr.endsWith(QLatin1Char(')'))) {
-            str = defValStr;
-            return str;
+    switch (mapping.params) {
+    case TypeParams::DisplayWidth:
+        if (displayWidth > 0) {
+            appendLength(sql, displayWidth);
         }
-        if (defValStr.compare(QLatin1String("NULL"), Qt::CaseInsensitive) == 0) {
-            if (_nullable) {
-                str = defValStr;
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value NULL for column" << q->objectName() << "of type" << typeString() << ": not nullable";
+        break;
+    case TypeParams::PrecisionScale:
+        appendPrecision(sql, precision, scale);
+        break;
+    case TypeParams::Length:
+        appendLength(sql, length);
+        break;
+    case TypeParams::Values:
+    {
+        sql << QLatin1Char('(');
+        bool first = true;
+        for (const QString &part : enumSet) {
+            if (!first) {
+                sql << QLatin1String(", ");
             }
-            return str;
+            sql.stringLiteral(part);
+            first = false;
         }
+        sql << QLatin1Char(')');
+        break;
+    }
+    case TypeParams::None:
+    case TypeParams::Unsupported:
+        break;
+    }
+}
 
-        if (type < Bit) { // numeric columns
-            bool isDouble = false;
-            bool isInteger = false;
-            defVal.toDouble(&isDouble);
-            defVal.toLongLong(&isInteger);
-            if ((isDouble || isInteger) && defVal.canConvert<QString>()) {
-                str = defVal.toString();
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == Bit) {
-            if (defVal.canConvert<QBitArray>()) {
-                const QBitArray ba = defVal.toBitArray();
-                if (!ba.isEmpty()) {
-                    int length = ba.size();
-                    if (length > 63) {
-                        length = 63;
-                    }
-                    str.reserve(length + 4);
-                    str[0] = QLatin1Char('\'');
-                    str[1] = QLatin1Char('0');
-                    str[2] = QLatin1Char('b');
-                    for (int i = 0; i < length; ++i) {
-                        str[i+3] = ba.at(i) ? QLatin1Char('1') : QLatin1Char('0');
-                    }
-                    str[length + 3] = QLatin1Char('\'');
-                }
-            } else if (defVal.canConvert<QString>()) {
-                str = defVal.toString();
-                if (!str.startsWith(QLatin1String("b'"))) {
-                    str.prepend(QLatin1String("b'"));
-                }
-                if (!str.endsWith(QLatin1Char('\''))) {
-                    str.append(QLatin1Char('\''));
-                }
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == Date) {
-            if (defVal.canConvert<QDate>()) {
-                str = QLatin1Char('\'') + defVal.toDate().toString(Qt::ISODate) + QLatin1Char('\'');
-            } else if (defVal.canConvert<QString>()) {
-                str = QLatin1Char('\'') + defVal.toString() + QLatin1Char('\'');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == DateTime || type == Timestamp) {
-            if (defVal.type() == QMetaType::QDateTime) {
-                str = QLatin1Char('\'') + defVal.toDateTime().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")) + QLatin1Char('\'');
-            } else if (defVal.canConvert<QString>()) {
-                if (defValStr.compare(QLatin1String("CURRENT_TIMESTAMP"), Qt::CaseInsensitive) == 0) {
-                    str = defValStr;
-                } else {
-                    str = QLatin1Char('\'') + defVal.toString() + QLatin1Char('\'');
-                }
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == Time) {
-            if (defVal.canConvert<QTime>()) {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
-                str = QLatin1Char('\'') + defVal.toTime().toString(Qt::ISODateWithMs) + QLatin1Char('\'');
-#else
-                str = QLatin1Char('\'') + defVal.toTime().toString(QStringLiteral("HH:MM:ss.zzz")) + QLatin1Char('\'');
-#endif
-            } else if (defVal.canConvert<QString>()) {
-                str = QLatin1Char('\'') + defVal.toString() + QLatin1Char('\'');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == Year) {
-            if (defVal.canConvert<QString>()) {
-                str = QLatin1Char('\'') + defVal.toString() + QLatin1Char('\'');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type > Year && type < TinyBlob) { // binay type columns
-            if (defVal.canConvert<QString>()) {
-                str = QLatin1Char('\'') + defVal.toString() + QLatin1Char('\'');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type >= TinyBlob && type <= LongBlob) { // blob type columns
-            if (defVal.canConvert<QByteArray>()) {
-                str = QLatin1String("('0x") + QString::fromLatin1(defVal.toByteArray().toHex()) + QLatin1String("')");
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type >= Char && type <= Json) { // char and text type columns
-            if (defVal.canConvert<QString>()) {
-                QString _str = defVal.toString();
-                _str.replace(QLatin1Char('\''), QLatin1String("\\'"));
-                str = QLatin1String("('") + _str + QLatin1String("')");
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type == Boolean) {
-            if (defVal.canConvert<bool>()) {
-                str = defVal.toBool() ? QLatin1Char('1') : QLatin1Char('0');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        }
+QString ColumnPrivate::typeString() const
+{
+    SqlBuilder sql(context->dialect, 32);
+    renderType(sql);
+    return sql.take();
+}
 
-    } else if (dbType() == Migrator::SQLite) {
+void ColumnPrivate::renderDefVal(SqlBuilder &sql) const
+{
+    context->dialect->renderDefVal(sql, *this);
+}
 
-        QString defValStr = defVal.toString();
-        if (!defValStr.isEmpty()) {
-            if (defValStr.compare(QLatin1String("CURRENT_TIME"), Qt::CaseInsensitive) == 0 || defValStr.compare(QLatin1String("CURRENT_DATE"), Qt::CaseInsensitive) == 0 || defValStr.compare(QLatin1String("CURRENT_TIMESTAMP"), Qt::CaseInsensitive) == 0) {
-                str = defValStr;
-                return str;
-            }
-            if (defValStr.compare(QLatin1String("NULL"), Qt::CaseInsensitive) == 0) {
-                if (_nullable) {
-                    str = defValStr;
-                } else {
-                    qCWarning(FIR_CORE) << "Invalid default value NULL for column" << q->objectName() << "of type" << typeString() << ": not nullable";
-                }
-                return str;
-            }
-        }
+QString ColumnPrivate::defValString() const
+{
+    SqlBuilder sql(context->dialect, 32);
+    renderDefVal(sql);
+    return sql.take();
+}
 
-        if (defValStr.startsWith(QLatin1Char('(')) && defValStr.endsWith(QLatin1Char(')'))) {
-            str = defValStr;
-            return str;
-        }
+QString ColumnPrivate::schemaAndColName() const
+{
+    return table->q_func()->objectName() + QLatin1Char('.') + name;
+}
 
-        if (type < Bit) { // numeric values
-            bool isInteger = false;
-            bool isDouble = false;
-            defVal.toLongLong(&isInteger);
-            defVal.toDouble(&isDouble);
-            if (isInteger || isDouble) {
-                str = defValStr;
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if (type >= TinyBlob && type <= LongBlob) {
-            if (defValStr.startsWith(QLatin1String("x'")) && defValStr.endsWith(QLatin1Char('\''))) {
-                str = defValStr;
-            } else if (defVal.canConvert<QByteArray>()) {
-                const auto ba = defVal.toByteArray();
-                str = QLatin1String("x'") + QString::fromLatin1(defVal.toByteArray().toHex()) + QLatin1Char('\'');
-            } else {
-                qCWarning(FIR_CORE) << "Invalid default value for column" << q->objectName() << "of type" << typeString() << ":" << defVal;
-            }
-        } else if ((type == Binary || type == VarBinary || (type >= Char && type <= LongText)) && defVal.canConvert<QString>()) {
-            QString _str = defVal.toString();
-            _str.replace(QLatin1Char('\''), QLatin1String("\\'"));
-            str = QLatin1Char('\'') + _str + QLatin1Char('\'');
-        }
+IndexPart *ColumnPrivate::indexPart(const QString &col)
+{
+    const auto idx = constraintCols.indexOf(col);
+    if (idx < 0) {
+        return nullptr;
+    }
+    if (indexParts.size() < static_cast<std::size_t>(constraintCols.size())) {
+        indexParts.resize(static_cast<std::size_t>(constraintCols.size()));
     }
+    return &indexParts[static_cast<std::size_t>(idx)];
+}
 
-    return str;
+void ColumnPrivate::setDirty()
+{
+    dirty = true;
+    table->dirty = true;
 }
 
-QString ColumnPrivate::schemaAndColName() const
+void ColumnPrivate::renderDefinition(SqlBuilder &sql) const
 {
-    Q_Q(const Column);
-    return q->parent()->objectName() + QLatin1Char('.') + q->objectName();
+    sql.separate().identifier(name);
+    sql.separate();
+    renderType(sql);
+    if (type < Bit && _unsigned && isDbFeatureAvailable(Migrator::UnsignedInteger)) {
+        sql.word(QLatin1String("UNSIGNED"));
+    }
+    if (type > LongBlob && type < Enum) {
+        if (!charset.isEmpty()) {
+            sql.word(QLatin1String("CHARACTER SET ")) << charset;
+        }
+        if (!collation.isEmpty()) {
+            sql.word(QLatin1String("COLLATE ")) << collation;
+        }
+    }
+    if (_primaryKey || _autoIncrement) {
+        sql.word(QLatin1String("PRIMARY KEY"));
+    }
+    if (_autoIncrement) {
+        sql.word(context->dialect->autoIncrementKeyword());
+    }
+    if (_unique) {
+        sql.word(context->dialect->uniqueKeyword());
+    }
+    if (!_nullable || _primaryKey) {
+        sql.word(QLatin1String("NOT NULL"));
+    }
+    if (!defVal.isNull()) {
+        const SqlBuilder::size_type defStart = sql.size();
+        sql.word(QLatin1String("DEFAULT "));
+        const SqlBuilder::size_type valStart = sql.size();
+        renderDefVal(sql);
+        if (sql.size() == valStart) {
+            sql.truncate(defStart);
+        }
+    }
+    if (!comment.isEmpty()) {
+        sql.word(QLatin1String("COMMENT "));
+        sql.stringLiteral(comment);
+    }
 }
 
-QString ColumnPrivate::queryString() const
+void ColumnPrivate::renderQuery(SqlBuilder &sql) const
 {
-    QString qs;
+    if (!dirty) {
+        sql << renderedQuery;
+        return;
+    }
 
-    QStringList parts;
-    Q_Q(const Column);
+    const SqlBuilder::size_type start = sql.size();
+    sql.startFragment();
 
     if ((operation == CreateColumn || operation == AddColumn) && type < Key) {
         if (type == Invalid) {
-            return qs;
+            return;
         }
 
         if (operation == AddColumn) {
-            parts << QStringLiteral("ADD") << QStringLiteral("COLUMN");
+            sql.word(QLatin1String("ADD COLUMN"));
         }
 
-        parts << q->objectName();
-        parts << typeString();
-        if (type < Bit && _unsigned && dbType() != Migrator::SQLite) {
-            parts << QStringLiteral("UNSIGNED");
-        }
-        if (type > LongBlob && type < Enum) {
-            if (!charset.isEmpty()) {
-                const QString cs = QStringLiteral("CHARACTER SET ") + charset;
-                parts << cs;
+        renderDefinition(sql);
+    }
+
+    if ((operation == CreateColumn || operation == AddColumn) && type >= Key && type <= ForeignKey) {
+        const TypeMapping *mappings = context->dialect->typeMappings();
+        // index types without a name in the dialect can not be part of a table definition
+        if (mappings && mappings[type].name) {
+            if (operation == AddColumn) {
+                sql.word(QLatin1String("ADD"));
             }
-            if (!collation.isEmpty()) {
-                const QString cs = QStringLiteral("COLLATE ") + collation;
-                parts << cs;
+            if (!name.isEmpty()) {
+                sql.word(QLatin1String("CONSTRAINT ")).identifier(name);
             }
-        }
-        if (_primaryKey || _autoIncrement) {
-            parts << QStringLiteral("PRIMARY KEY");
-        }
-        if (_autoIncrement) {
-            if (dbType() == Migrator::SQLite) {
-                parts << QStringLiteral("AUTOINCREMENT");
-            } else {
-                parts << QStringLiteral("AUTO_INCREMENT");
+            sql.separate();
+            renderType(sql);
+            if (!indexName.isEmpty()) {
+                sql.separate().identifier(indexName);
             }
-        }
-        if (_unique) {
-            if (dbType() == Migrator::SQLite) {
-                parts << QStringLiteral("UNIQUE");
+            sql.separate();
+            if (type == ForeignKey) {
+                sql.list(constraintCols);
             } else {
-                parts << QStringLiteral("UNIQUE KEY");
-            }
-        }
-        if (!_nullable || _primaryKey) {
-            parts << QStringLiteral("NOT NULL");
-        }
-        if (!defVal.isNull()) {
-            const auto _def = defValString();
-            if (!_def.isEmpty()) {
-                parts << QStringLiteral("DEFAULT");
-                parts << _def;
+                context->dialect->renderIndexParts(sql, *this);
             }
-        }
-        if (!comment.isEmpty()) {
-            const QString _comment = QLatin1Char('\'') + comment + QLatin1Char('\'');
-            parts << QStringLiteral("COMMENT");
-            parts << _comment;
-        }
-    }
 
-    if (operation == CreateColumn && type >= Key && type <= ForeignKey) {
-        if (type == Invalid) {
-            return qs;
-        }
+            if (type == FulltextIndex && !parser.isEmpty()) {
+                sql.word(QLatin1String("WITH PARSER ")) << parser;
+            }
 
-        if (!q->objectName().isEmpty()) {
-            parts << QStringLiteral("CONSTRAINT") << q->objectName();
-        }
-        parts << typeString();
-        if (!indexName.isEmpty()) {
-            parts << indexName;
-        }
-        const QString _keyCols = QLatin1Char('(') + constraintCols.join(QLatin1Char(',')) + QLatin1Char(')');
-        parts << _keyCols;
+            if (type == ForeignKey) {
+                sql.word(QLatin1String("REFERENCES ")).identifier(referenceTable);
+                sql.separate().list(referenceCols);
 
-        if (type == ForeignKey) {
-            parts << QStringLiteral("REFERENCES") << referenceTable;
-            const QString _refCols = QLatin1Char('(') + referenceCols.join(QLatin1Char(',')) + QLatin1Char(')');
-            parts << _refCols;
+                if (!onDelete.isEmpty()) {
+                    sql.word(QLatin1String("ON DELETE ")) << onDelete;
+                }
 
-            if (!onDelete.isEmpty()) {
-                parts << QStringLiteral("ON DELETE") << onDelete;
+                if (!onUpdate.isEmpty()) {
+                    sql.word(QLatin1String("ON UPDATE ")) << onUpdate;
+                }
             }
 
-            if (!onUpdate.isEmpty()) {
-                parts << QStringLiteral("ON UPDATE") << onUpdate;
+            if (!comment.isEmpty()) {
+                sql.word(QLatin1String("COMMENT "));
+                sql.stringLiteral(comment);
             }
         }
+    }
 
-        if (!comment.isEmpty()) {
-            const QString _comment = QLatin1Char('\'') + comment + QLatin1Char('\'');
-            parts << QStringLiteral("COMMENT");
-            parts << _comment;
-        }
+    if (operation == ModifyColumn && type > Invalid && type < Key) {
+        context->dialect->renderModifyColumn(sql, *this);
     }
 
-    if (operation == DropColumn && type < Key) {
-        parts << QStringLiteral("DROP") << QStringLiteral("COLUMN") << q->objectName();
+    if (operation == DropColumn && type >= Key) {
+        context->dialect->renderDropKey(sql, *this);
     }
 
-    qs = parts.join(QChar(QChar::Space));
+    if (operation == DropColumn && type < Key) {
+        sql.word(QLatin1String("DROP COLUMN ")).identifier(name);
+    }
 
 #ifndef QT_NO_DEBUG_OUTPUT
-    switch (operation) {
-    case CreateColumn:
-        qCDebug(FIR_CORE, "Creating column: %s", qUtf8Printable(qs));
-        break;
-    case AddColumn:
-        qCDebug(FIR_CORE, "Adding column: %s", qUtf8Printable(qs));
-        break;
-    case ModifyColumn:
-        qCDebug(FIR_CORE, "Modifying column: %s", qUtf8Printable(qs));
-        break;
-    case DropColumn:
-        qCDebug(FIR_CORE, "Dropping column: %s", qUtf8Printable(qs));
-        break;
+    if (sql.size() > start) {
+        switch (operation) {
+        case CreateColumn:
+            qCDebug(FIR_CORE, "Creating column: %s", qUtf8Printable(sql.mid(start)));
+            break;
+        case AddColumn:
+            qCDebug(FIR_CORE, "Adding column: %s", qUtf8Printable(sql.mid(start)));
+            break;
+        case ModifyColumn:
+            qCDebug(FIR_CORE, "Modifying column: %s", qUtf8Printable(sql.mid(start)));
+            break;
+        case DropColumn:
+            qCDebug(FIR_CORE, "Dropping column: %s", qUtf8Printable(sql.mid(start)));
+            break;
+        }
     }
 #endif
 
-    return qs;
-}
-
-Migrator::DatabaseType ColumnPrivate::dbType() const
-{
-    Q_Q(const Column);
-    auto table = qobject_cast<Table*>(q->parent());
-    auto migration = qobject_cast<Migration*>(table->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbType();
-}
-
-QString ColumnPrivate::dbTypeToStr() const
-{
-    Q_Q(const Column);
-    auto table = qobject_cast<Table*>(q->parent());
-    auto migration = qobject_cast<Migration*>(table->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbTypeToStr();
-}
-
-QVersionNumber ColumnPrivate::dbVersion() const
-{
-    Q_Q(const Column);
-    auto table = qobject_cast<Table*>(q->parent());
-    auto migration = qobject_cast<Migration*>(table->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbVersion();
-}
-
-Migrator::DatabaseFeatures ColumnPrivate::dbFeatures() const
-{
-    Q_Q(const Column);
-    auto table = qobject_cast<Table*>(q->parent());
-    auto migration = qobject_cast<Migration*>(table->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbFeatures();
-}
-
-bool ColumnPrivate::isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const
-{
-    Q_Q(const Column);
-    auto table = qobject_cast<Table*>(q->parent());
-    auto migration = qobject_cast<Migration*>(table->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->isDbFeatureAvailable(dbFeatures);
+    renderedQuery = sql.mid(start);
+    dirty = false;
 }
 
-Column::Column(Table *parent) : QObject(parent), dptr(new ColumnPrivate)
+QString ColumnPrivate::queryString() const
 {
-    Q_D(Column);
-    d->q_ptr = this;
+    SqlBuilder sql(context->dialect, 128);
+    renderQuery(sql);
+    return sql.take();
 }
 
-Column::~Column() = default;
-
 Column* Column::autoIncrement(bool autoIncrement)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type < ColumnPrivate::Decimal || (d->type > ColumnPrivate::Numeric && d->type < ColumnPrivate::Bit)) {
         d->_autoIncrement = autoIncrement;
     } else {
@@ -683,6 +290,7 @@ Column* Column::autoIncrement(bool autoIncrement)
 Column* Column::unSigned(bool unSigned)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->isDbFeatureAvailable(Migrator::UnsignedInteger)) {
         if (d->type < ColumnPrivate::Bit) {
             d->_unsigned = unSigned;
@@ -699,6 +307,7 @@ Column* Column::unSigned(bool unSigned)
 Column* Column::charset(const QString &charset)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->isDbFeatureAvailable(Migrator::CharsetOnColumn)) {
         if (d->type >= ColumnPrivate::Char && d->type <= ColumnPrivate::Set) {
             d->charset = charset;
@@ -718,6 +327,7 @@ Column* Column::charset(const QString &charset)
 Column* Column::collation(const QString &collation)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type >= ColumnPrivate::Char && d->type <= ColumnPrivate::Set) {
         d->collation = collation;
     } else {
@@ -729,6 +339,7 @@ Column* Column::collation(const QString &collation)
 Column* Column::defaultValue(const QVariant &defVal)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type < ColumnPrivate::Key) {
         if ((d->type > ColumnPrivate::VarBinary && d->type < ColumnPrivate::Char) && !d->isDbFeatureAvailable(Migrator::DefValOnBlob)) {
             qCWarning(FIR_CORE, "%s %s does not support DEFAULT values on BLOB type columns. \"%s\" is of type %s.", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(d->schemaAndColName()),  qUtf8Printable(d->typeString()));
@@ -748,6 +359,7 @@ Column* Column::defaultValue(const QVariant &defVal)
 Column *Column::nullable(bool isNullable)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type < ColumnPrivate::Key) {
         d->_nullable = isNullable;
     } else {
@@ -759,6 +371,7 @@ Column *Column::nullable(bool isNullable)
 Column *Column::useCurrent(bool useCurrent)
 {
     Q_D(Column);
+    d->setDirty();
     d->_useCurrent = useCurrent;
     return this;
 }
@@ -766,6 +379,7 @@ Column *Column::useCurrent(bool useCurrent)
 Column *Column::primary(bool primary)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type < ColumnPrivate::Key) {
         d->_primaryKey = primary;
     } else {
@@ -777,6 +391,7 @@ Column *Column::primary(bool primary)
 Column *Column::unique(bool unique)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type < ColumnPrivate::Key) {
         d->_unique = unique;
     } else {
@@ -788,6 +403,7 @@ Column *Column::unique(bool unique)
 Column *Column::onDelete(const QString &referenceOption)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type == ColumnPrivate::ForeignKey) {
         d->onDelete = referenceOption;
     } else {
@@ -799,6 +415,7 @@ Column *Column::onDelete(const QString &referenceOption)
 Column *Column::onUpdate(const QString &referenceOption)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->type == ColumnPrivate::ForeignKey) {
         d->onUpdate = referenceOption;
     } else {
@@ -807,12 +424,66 @@ Column *Column::onUpdate(const QString &referenceOption)
     return this;
 }
 
+Column *Column::prefixLength(const QString &col, uint length)
+{
+    Q_D(Column);
+    d->setDirty();
+    if (!d->isDbFeatureAvailable(Migrator::IndexPartOptions)) {
+        qCWarning(FIR_CORE, "%s: Prefix lengths on index columns are not supported by %s %s.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()));
+        return this;
+    }
+    if (d->type != ColumnPrivate::Key && d->type != ColumnPrivate::PrimaryKey && d->type != ColumnPrivate::UniqueKey) {
+        qCWarning(FIR_CORE, "prefixLength() is only usable on primary, unique and plain keys. \"%s\" is of type %s.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(d->typeString()));
+        return this;
+    }
+    IndexPart *part = d->indexPart(col);
+    if (part) {
+        part->length = length;
+    } else {
+        qCWarning(FIR_CORE, "%s: Can not set prefix length, \"%s\" is not part of the index.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(col));
+    }
+    return this;
+}
+
+Column *Column::descending(const QString &col, bool descending)
+{
+    Q_D(Column);
+    d->setDirty();
+    if (!d->isDbFeatureAvailable(Migrator::IndexPartOptions)) {
+        qCWarning(FIR_CORE, "%s: Descending index columns are not supported by %s %s.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()));
+        return this;
+    }
+    if (d->type != ColumnPrivate::Key && d->type != ColumnPrivate::PrimaryKey && d->type != ColumnPrivate::UniqueKey) {
+        qCWarning(FIR_CORE, "descending() is only usable on primary, unique and plain keys. \"%s\" is of type %s.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(d->typeString()));
+        return this;
+    }
+    IndexPart *part = d->indexPart(col);
+    if (part) {
+        part->descending = descending;
+    } else {
+        qCWarning(FIR_CORE, "%s: Can not set sort order, \"%s\" is not part of the index.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(col));
+    }
+    return this;
+}
+
+Column *Column::withParser(const QString &parser)
+{
+    Q_D(Column);
+    d->setDirty();
+    if (d->type == ColumnPrivate::FulltextIndex) {
+        d->parser = parser.trimmed();
+    } else {
+        qCWarning(FIR_CORE, "withParser() / WITH PARSER index option is only usable on FULLTEXT indexes. \"%s\" is of type %s.", qUtf8Printable(d->schemaAndColName()), qUtf8Printable(d->typeString()));
+    }
+    return this;
+}
+
 Column *Column::comment(const QString &comment)
 {
     Q_D(Column);
+    d->setDirty();
     if (d->isDbFeatureAvailable(Migrator::CommentsOnColumns)) {
         QString _comment = comment;
-        _comment.replace(QLatin1Char('\''), QLatin1String("\\'"));
         if (_comment.size() > 1024) {
             qCWarning(FIR_CORE, "%s: comment() / COMMENT can not exceed 1024 characters. Your comment is %i characters long. It will be truncated.", qUtf8Printable(d->schemaAndColName()), _comment.size());
             _comment = _comment.left(1024);
@@ -828,19 +499,20 @@ Column *Column::comment(const QString &comment)
 void Column::after(const QString &otherColumn)
 {
     Q_D(Column);
+    d->setDirty();
     d->after = otherColumn;
 }
 
 void Column::first()
 {
     Q_D(Column);
+    d->setDirty();
     d->_first = true;
 }
 
 void Column::change()
 {
     Q_D(Column);
+    d->setDirty();
     d->operation = ColumnPrivate::ModifyColumn;
 }
-
-#include "moc_column.cpp"
@@ -8,7 +8,7 @@
 
 #include "firfuorida_global.h"
 #include "firfuorida_export.h"
-#include <QObject>
+#include <QString>
 #include <QVariant>
 #include <QtGlobal>
 
@@ -20,7 +20,9 @@ class Table;
 /*!
  * \brief Contains information about a single column, either to creaste or to modify.
  *
- * The %Column object can only be created by functions of the Table class.
+ * The %Column object can only be created by functions of the Table class. It is a
+ * lightweight handle to the column data that is stored inside the Table and stays
+ * valid as long as the Table exists.
  *
  * <h2>Example</h2>
  * example.cpp
@@ -28,21 +30,16 @@ class Table;
  *
  * \headerfile "" <Firfuorida/Column>
  */
-class FIRFUORIDA_EXPORT Column : public QObject
+class FIRFUORIDA_EXPORT Column
 {
-    Q_OBJECT
-    Q_DISABLE_COPY(Column)
-    friend class Table;
-    friend class TablePrivate;
-    const QScopedPointer<ColumnPrivate> dptr;
-    F_DECLARE_PRIVATE_D(dptr, Column)
-    explicit Column(Table *parent);
+    friend class ColumnPrivate;
+    inline ColumnPrivate* d_func();
+    inline const ColumnPrivate* d_func() const;
+    Column() = default;
+    Column(const Column &other) = default;
+    Column& operator=(const Column &other) = default;
+    ~Column() = default;
 public:
-    /*!
-     * \brief Deconstructs the %Column object.
-     */
-    ~Column() override;
-
     /*!
      * \brief Enables or disables the auto increment feature for this column.
      */
@@ -84,6 +81,39 @@ public:
      * \brief Adds the onUpdate action to a foreign key column.
      */
     Column* onUpdate(const QString &referenceOption);
+    /*!
+     * \brief Indexes only the first \a length characters or bytes of the index column \a col.
+     *
+     * Only usable on primary, unique and plain keys, keeps indexes on long VARCHAR, TEXT
+     * and BLOB columns small.
+     * \par Example
+     * \code{.cpp}
+     * table->key(QStringList({"title","id"}))->prefixLength(QStringLiteral("title"), 32);
+     * \endcode
+     * \par MySQL statement
+     * \code{.sql}
+     * KEY (title(32),id)
+     * \endcode
+     */
+    Column* prefixLength(const QString &col, uint length);
+    /*!
+     * \brief Sorts the index column \a col in descending order if \a descending is \c true.
+     *
+     * Only usable on primary, unique and plain keys.
+     * \par MySQL statement
+     * \code{.sql}
+     * KEY (col DESC)
+     * \endcode
+     */
+    Column* descending(const QString &col, bool descending = true);
+    /*!
+     * \brief Uses the fulltext \a parser plugin, like \c ngram, for a fulltext index.
+     * \par MySQL statement
+     * \code{.sql}
+     * FULLTEXT INDEX (col) WITH PARSER ngram
+     * \endcode
+     */
+    Column* withParser(const QString &parser);
     /*!
      * \brief Add a \a comment to the column.
      * \note The maximum size for a column comment on MySQL/MariaDB is \c 1024 characters.
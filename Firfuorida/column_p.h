@@ -7,11 +7,37 @@
 #define FIRFUORIDA_COLUMN_P_H
 
 #include "column.h"
-#include "migrator.h"
+#include "migrator_p.h"
+#include <QStringList>
+#include <cstddef>
+#include <vector>
 
 namespace Firfuorida {
 
-class ColumnPrivate {
+class TablePrivate;
+class SqlBuilder;
+
+/*!
+ * \internal
+ * \brief Prefix length and sort order of a single column of an index.
+ */
+class IndexPart
+{
+public:
+    // number of leading characters or bytes that are indexed, 0 indexes the whole value
+    uint length = 0;
+    bool descending = false;
+};
+
+/*!
+ * \internal
+ * \brief Holds the data of a single column.
+ *
+ * %ColumnPrivate objects are stored by value inside TablePrivate. As it is derived
+ * from Column, a pointer to it is directly used as the Column handle returned by
+ * the Table functions.
+ */
+class ColumnPrivate : public Column {
 public:
     enum Type : quint8 {
         Invalid = 0,
@@ -57,6 +83,8 @@ public:
         ForeignKey
     };
 
+    static constexpr std::size_t TypeCount = ForeignKey + 1;
+
     enum ColumnOperation : quint8 {
         CreateColumn,
         AddColumn,
@@ -64,18 +92,37 @@ public:
         DropColumn
     };
 
+    void renderType(SqlBuilder &sql) const;
+    void renderDefVal(SqlBuilder &sql) const;
+    /*!
+     * \brief Appends name, type and attributes of a data column as used by CREATE TABLE and ADD COLUMN.
+     */
+    void renderDefinition(SqlBuilder &sql) const;
+    void renderQuery(SqlBuilder &sql) const;
+
     QString typeString() const;
     QString queryString() const;
     QString defValString() const;
 
     QString schemaAndColName() const;
 
-    Migrator::DatabaseType dbType() const;
-    QString dbTypeToStr() const;
-    QVersionNumber dbVersion() const;
-    Migrator::DatabaseFeatures dbFeatures() const;
-    bool isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const;
+    /*!
+     * \brief Returns the part of the index for \a col or \c nullptr if \a col is not part of this index.
+     */
+    IndexPart *indexPart(const QString &col);
+
+    /*!
+     * \brief Invalidates the rendered SQL of this column and its table.
+     */
+    void setDirty();
 
+    Migrator::DatabaseType dbType() const { return context->type; }
+    QString dbTypeToStr() const { return context->typeToStr(); }
+    QVersionNumber dbVersion() const { return context->version; }
+    Migrator::DatabaseFeatures dbFeatures() const { return context->features; }
+    bool isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const { return context->isFeatureAvailable(dbFeatures); }
+
+    QString name;
     QString charset;
     QString collation;
     QString after;
@@ -88,7 +135,13 @@ public:
     QStringList constraintCols;
     QStringList referenceCols;
     QStringList enumSet;
-    Column *q_ptr = nullptr;
+    // empty or one entry per constraintCols entry
+    std::vector<IndexPart> indexParts;
+    // fulltext parser plugin
+    QString parser;
+    mutable QString renderedQuery;
+    const TablePrivate *table = nullptr;
+    const DbContext *context = nullptr;
     uint precision = 10;
     uint scale = 0;
     uint length = 255;
@@ -102,9 +155,13 @@ public:
     bool _useCurrent = false;
     bool _first = false;
     bool _unique = false;
-    Q_DECLARE_PUBLIC(Column)
+    mutable bool dirty = true;
 };
 
+inline ColumnPrivate *Column::d_func() { return static_cast<ColumnPrivate *>(this); }
+
+inline const ColumnPrivate *Column::d_func() const { return static_cast<const ColumnPrivate *>(this); }
+
 }
 
 #endif // FIRFUORIDA_COLUMN_P_H
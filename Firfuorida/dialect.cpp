@@ -0,0 +1,1283 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "dialect_p.h"
+#include "column_p.h"
+#include "table_p.h"
+#include "sqlbuilder_p.h"
+#include "schema_p.h"
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QBitArray>
+#include <QSqlError>
+#include "logging.h"
+#include <cstddef>
+#include <algorithm>
+
+using namespace Firfuorida;
+
+namespace {
+
+template<std::size_t N>
+constexpr bool isCompleteMapping(const TypeMapping (&mappings)[N])
+{
+    if (N != ColumnPrivate::TypeCount) {
+        return false;
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        if (static_cast<std::size_t>(mappings[i].type) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr TypeMapping mysqlTypes[] = {
+    {ColumnPrivate::Invalid,        nullptr,            TypeParams::None},
+    {ColumnPrivate::TinyInt,        "TINYINT",          TypeParams::DisplayWidth},
+    {ColumnPrivate::SmallInt,       "SMALLINT",         TypeParams::DisplayWidth},
+    {ColumnPrivate::SmallSerial,    "SMALLINT",         TypeParams::DisplayWidth},
+    {ColumnPrivate::MediumInt,      "MEDIUMINT",        TypeParams::DisplayWidth},
+    {ColumnPrivate::Int,            "INT",              TypeParams::DisplayWidth},
+    {ColumnPrivate::Serial,         "INT",              TypeParams::DisplayWidth},
+    {ColumnPrivate::BigInt,         "BIGINT",           TypeParams::DisplayWidth},
+    {ColumnPrivate::BigSerial,      "BIGINT",           TypeParams::DisplayWidth},
+    {ColumnPrivate::Decimal,        "DECIMAL",          TypeParams::PrecisionScale},
+    {ColumnPrivate::Numeric,        "NUMERIC",          TypeParams::PrecisionScale},
+    {ColumnPrivate::Float,          "FLOAT",            TypeParams::PrecisionScale},
+    {ColumnPrivate::Double,         "DOUBLE",           TypeParams::PrecisionScale},
+    {ColumnPrivate::Bit,            "BIT",              TypeParams::Length},
+    {ColumnPrivate::Date,           "DATE",             TypeParams::None},
+    {ColumnPrivate::DateTime,       "DATETIME",         TypeParams::None},
+    {ColumnPrivate::Timestamp,      "TIMESTAMP",        TypeParams::None},
+    {ColumnPrivate::Time,           "TIME",             TypeParams::None},
+    {ColumnPrivate::Year,           "YEAR",             TypeParams::None},
+    {ColumnPrivate::Binary,         "BINARY",           TypeParams::Length},
+    {ColumnPrivate::VarBinary,      "VARBINARY",        TypeParams::Length},
+    {ColumnPrivate::TinyBlob,       "TINYBLOB",         TypeParams::None},
+    {ColumnPrivate::Blob,           "BLOB",             TypeParams::None},
+    {ColumnPrivate::MediumBlob,     "MEDIUMBLOB",       TypeParams::None},
+    {ColumnPrivate::LongBlob,       "LONGBLOB",         TypeParams::None},
+    {ColumnPrivate::Char,           "CHAR",             TypeParams::Length},
+    {ColumnPrivate::VarChar,        "VARCHAR",          TypeParams::Length},
+    {ColumnPrivate::TinyText,       "TINYTEXT",         TypeParams::None},
+    {ColumnPrivate::Text,           "TEXT",             TypeParams::None},
+    {ColumnPrivate::MediumText,     "MEDIUMTEXT",       TypeParams::None},
+    {ColumnPrivate::LongText,       "LONGTEXT",         TypeParams::None},
+    {ColumnPrivate::Json,           "JSON",             TypeParams::None},
+    {ColumnPrivate::Enum,           "ENUM",             TypeParams::Values},
+    {ColumnPrivate::Set,            "SET",              TypeParams::Values},
+    {ColumnPrivate::Boolean,        "TINYINT(1)",       TypeParams::None},
+    {ColumnPrivate::Key,            "KEY",              TypeParams::None},
+    {ColumnPrivate::FulltextIndex,  "FULLTEXT INDEX",   TypeParams::None},
+    {ColumnPrivate::SpatialIndex,   "SPATIAL INDEX",    TypeParams::None},
+    {ColumnPrivate::PrimaryKey,     "PRIMARY KEY",      TypeParams::None},
+    {ColumnPrivate::UniqueKey,      "UNIQUE KEY",       TypeParams::None},
+    {ColumnPrivate::ForeignKey,     "FOREIGN KEY",      TypeParams::None}
+};
+static_assert(isCompleteMapping(mysqlTypes), "MySQL type mapping is incomplete or not in the order of ColumnPrivate::Type");
+
+constexpr TypeMapping sqliteTypes[] = {
+    {ColumnPrivate::Invalid,        nullptr,            TypeParams::None},
+    {ColumnPrivate::TinyInt,        "INTEGER",          TypeParams::None},
+    {ColumnPrivate::SmallInt,       "INTEGER",          TypeParams::None},
+    {ColumnPrivate::SmallSerial,    "INTEGER",          TypeParams::None},
+    {ColumnPrivate::MediumInt,      "INTEGER",          TypeParams::None},
+    {ColumnPrivate::Int,            "INTEGER",          TypeParams::None},
+    {ColumnPrivate::Serial,         "INTEGER",          TypeParams::None},
+    {ColumnPrivate::BigInt,         "INTEGER",          TypeParams::None},
+    {ColumnPrivate::BigSerial,      "INTEGER",          TypeParams::None},
+    {ColumnPrivate::Decimal,        "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Numeric,        "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Float,          "REAL",             TypeParams::None},
+    {ColumnPrivate::Double,         "REAL",             TypeParams::None},
+    {ColumnPrivate::Bit,            "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Date,           "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::DateTime,       "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Timestamp,      "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Time,           "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Year,           "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Binary,         "TEXT",             TypeParams::None},
+    {ColumnPrivate::VarBinary,      "TEXT",             TypeParams::None},
+    {ColumnPrivate::TinyBlob,       "BLOB",             TypeParams::None},
+    {ColumnPrivate::Blob,           "BLOB",             TypeParams::None},
+    {ColumnPrivate::MediumBlob,     "BLOB",             TypeParams::None},
+    {ColumnPrivate::LongBlob,       "BLOB",             TypeParams::None},
+    {ColumnPrivate::Char,           "TEXT",             TypeParams::None},
+    {ColumnPrivate::VarChar,        "TEXT",             TypeParams::None},
+    {ColumnPrivate::TinyText,       "TEXT",             TypeParams::None},
+    {ColumnPrivate::Text,           "TEXT",             TypeParams::None},
+    {ColumnPrivate::MediumText,     "TEXT",             TypeParams::None},
+    {ColumnPrivate::LongText,       "TEXT",             TypeParams::None},
+    {ColumnPrivate::Json,           "TEXT",             TypeParams::None},
+    {ColumnPrivate::Enum,           "ENUM",             TypeParams::Unsupported},
+    {ColumnPrivate::Set,            "SET",              TypeParams::Unsupported},
+    {ColumnPrivate::Boolean,        "NUMERIC",          TypeParams::None},
+    {ColumnPrivate::Key,            "KEY",              TypeParams::None},
+    {ColumnPrivate::FulltextIndex,  nullptr,            TypeParams::None},
+    {ColumnPrivate::SpatialIndex,   nullptr,            TypeParams::None},
+    {ColumnPrivate::PrimaryKey,     "PRIMARY KEY",      TypeParams::None},
+    {ColumnPrivate::UniqueKey,      "UNIQUE",           TypeParams::None},
+    {ColumnPrivate::ForeignKey,     "FOREIGN KEY",      TypeParams::None}
+};
+static_assert(isCompleteMapping(sqliteTypes), "SQLite type mapping is incomplete or not in the order of ColumnPrivate::Type");
+
+constexpr TypeMapping psqlTypes[] = {
+    {ColumnPrivate::Invalid,        nullptr,            TypeParams::None},
+    {ColumnPrivate::TinyInt,        "SMALLINT",         TypeParams::None},
+    {ColumnPrivate::SmallInt,       "SMALLINT",         TypeParams::None},
+    {ColumnPrivate::SmallSerial,    "SMALLSERIAL",      TypeParams::None},
+    {ColumnPrivate::MediumInt,      "INTEGER",          TypeParams::None},
+    {ColumnPrivate::Int,            "INTEGER",          TypeParams::None},
+    {ColumnPrivate::Serial,         "SERIAL",           TypeParams::None},
+    {ColumnPrivate::BigInt,         "BIGINT",           TypeParams::None},
+    {ColumnPrivate::BigSerial,      "BIGSERIAL",        TypeParams::None},
+    {ColumnPrivate::Decimal,        "DECIMAL",          TypeParams::PrecisionScale},
+    {ColumnPrivate::Numeric,        "NUMERIC",          TypeParams::PrecisionScale},
+    {ColumnPrivate::Float,          "REAL",             TypeParams::None},
+    {ColumnPrivate::Double,         "DOUBLE PRECISION", TypeParams::None},
+    {ColumnPrivate::Bit,            "BIT",              TypeParams::Length},
+    {ColumnPrivate::Date,           "DATE",             TypeParams::None},
+    {ColumnPrivate::DateTime,       "TIMESTAMP",        TypeParams::None},
+    {ColumnPrivate::Timestamp,      "TIMESTAMP",        TypeParams::None},
+    {ColumnPrivate::Time,           "TIME",             TypeParams::None},
+    {ColumnPrivate::Year,           nullptr,            TypeParams::None},
+    {ColumnPrivate::Binary,         "BYTEA",            TypeParams::None},
+    {ColumnPrivate::VarBinary,      "BYTEA",            TypeParams::None},
+    {ColumnPrivate::TinyBlob,       "BYTEA",            TypeParams::None},
+    {ColumnPrivate::Blob,           "BYTEA",            TypeParams::None},
+    {ColumnPrivate::MediumBlob,     "BYTEA",            TypeParams::None},
+    {ColumnPrivate::LongBlob,       "BYTEA",            TypeParams::None},
+    {ColumnPrivate::Char,           "CHAR",             TypeParams::Length},
+    {ColumnPrivate::VarChar,        "VARCHAR",          TypeParams::Length},
+    {ColumnPrivate::TinyText,       "TEXT",             TypeParams::None},
+    {ColumnPrivate::Text,           "TEXT",             TypeParams::None},
+    {ColumnPrivate::MediumText,     "TEXT",             TypeParams::None},
+    {ColumnPrivate::LongText,       "TEXT",             TypeParams::None},
+    {ColumnPrivate::Json,           "JSON",             TypeParams::None},
+    {ColumnPrivate::Enum,           "BOOLEAN",          TypeParams::None},
+    {ColumnPrivate::Set,            "BOOLEAN",          TypeParams::None},
+    {ColumnPrivate::Boolean,        "BOOLEAN",          TypeParams::None},
+    {ColumnPrivate::Key,            nullptr,            TypeParams::None},
+    {ColumnPrivate::FulltextIndex,  nullptr,            TypeParams::None},
+    {ColumnPrivate::SpatialIndex,   nullptr,            TypeParams::None},
+    {ColumnPrivate::PrimaryKey,     "PRIMARY KEY",      TypeParams::None},
+    {ColumnPrivate::UniqueKey,      "UNIQUE",           TypeParams::None},
+    {ColumnPrivate::ForeignKey,     "FOREIGN KEY",      TypeParams::None}
+};
+static_assert(isCompleteMapping(psqlTypes), "PostgreSQL type mapping is incomplete or not in the order of ColumnPrivate::Type");
+
+/*!
+ * \internal
+ * \brief Appends the partition bound \a value, the values of lists are separated by comma.
+ */
+void renderPartitionValue(SqlBuilder &sql, const QVariant &value)
+{
+    if (value.type() == QMetaType::QVariantList) {
+        bool first = true;
+        const QVariantList values = value.toList();
+        for (const QVariant &v : values) {
+            if (!first) {
+                sql << QLatin1String(", ");
+            }
+            renderPartitionValue(sql, v);
+            first = false;
+        }
+    } else if (value.type() == QMetaType::Int || value.type() == QMetaType::UInt || value.type() == QMetaType::LongLong || value.type() == QMetaType::ULongLong || value.type() == QMetaType::Double) {
+        sql << value.toString();
+    } else if (value.type() == QMetaType::QDate) {
+        sql.stringLiteral(value.toDate().toString(Qt::ISODate));
+    } else if (value.type() == QMetaType::QDateTime) {
+        sql.stringLiteral(value.toDateTime().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss")));
+    } else {
+        sql.stringLiteral(value.toString());
+    }
+}
+
+/*!
+ * \internal
+ * \brief Appends the range bound \a value in parentheses or \a unbounded once for every key column if it is null.
+ */
+void renderRangeBound(SqlBuilder &sql, const TablePrivate &table, const QVariant &value, QLatin1String unbounded)
+{
+    sql << QLatin1Char('(');
+    if (value.isNull()) {
+        const int keyCols = table.partitionKey.isEmpty() ? 1 : static_cast<int>(table.partitionKey.size());
+        for (int i = 0; i < keyCols; ++i) {
+            if (i > 0) {
+                sql << QLatin1String(", ");
+            }
+            sql << unbounded;
+        }
+    } else {
+        renderPartitionValue(sql, value);
+    }
+    sql << QLatin1Char(')');
+}
+
+class MySqlDialect : public Dialect
+{
+public:
+    Migrator::DatabaseFeatures features(const QVersionNumber &version) const override
+    {
+        Migrator::DatabaseFeatures f = Migrator::GeometryTypes;
+        if (version >= QVersionNumber(5,7,8)) {
+            f |= Migrator::JSONTypes;
+        }
+        if (version >= QVersionNumber(8,0,13)) {
+            f |= Migrator::DefValOnText;
+            f |= Migrator::DefValOnBlob;
+            f |= Migrator::DefValOnGeometry;
+        }
+        return f | commonFeatures();
+    }
+
+    const TypeMapping *typeMappings() const override { return mysqlTypes; }
+
+    void renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const override;
+
+    QChar identifierQuote() const override { return QLatin1Char('`'); }
+    bool backslashEscapes() const override { return true; }
+
+    QString migrationsTableQuery(const QString &migrationsTable) const override
+    {
+        return QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
+                              "migration VARCHAR(255) NOT NULL, "
+                              "applied DATETIME DEFAULT CURRENT_TIMESTAMP, "
+                              "checksum VARCHAR(32), "
+                              "source_checksum VARCHAR(32), "
+                              "execution_time INTEGER, "
+                              "batch INTEGER, "
+                              "phase INTEGER, "
+                              "progress INTEGER, "
+                              "lag_wait INTEGER, "
+                              "UNIQUE KEY migration (migration)"
+                              ") DEFAULT CHARSET = latin1").arg(migrationsTable);
+    }
+
+    bool loadSchema(QSqlDatabase &db, Schema &schema, Error &error) const override
+    {
+        return loadMySqlSchema(db, schema, error);
+    }
+
+    QString lockTimeoutQuery(int msecs) const override
+    {
+        // lock_wait_timeout only takes whole seconds, it also applies to metadata locks
+        return QStringLiteral("SET SESSION lock_wait_timeout = %1").arg(std::max(1, (msecs + 999) / 1000));
+    }
+
+    QString currentLockTimeoutQuery() const override
+    {
+        return QStringLiteral("SELECT @@SESSION.lock_wait_timeout");
+    }
+
+    QString restoreLockTimeoutQuery(const QString &value) const override
+    {
+        return QStringLiteral("SET SESSION lock_wait_timeout = %1").arg(value.toLongLong());
+    }
+
+    QString connectionIdQuery() const override
+    {
+        return QStringLiteral("SELECT CONNECTION_ID()");
+    }
+
+    QString cancelQuery(const QString &id) const override
+    {
+        // only the statement is aborted, the connection stays open
+        return QStringLiteral("KILL QUERY %1").arg(id);
+    }
+
+    Error::Category classifyError(const QSqlError &error) const override
+    {
+        // client errors and server error numbers, see mysqld_error.h and errmsg.h
+        switch (error.nativeErrorCode().toInt()) {
+        case 1213:  // ER_LOCK_DEADLOCK
+            return Error::Deadlock;
+        case 1205:  // ER_LOCK_WAIT_TIMEOUT
+            return Error::LockTimeout;
+        case 1317:  // ER_QUERY_INTERRUPTED
+        case 3024:  // ER_QUERY_TIMEOUT
+            return Error::Cancelled;
+        case 1053:  // ER_SERVER_SHUTDOWN
+        case 1152:  // ER_ABORTING_CONNECTION
+        case 2002:  // CR_CONNECTION_ERROR
+        case 2003:  // CR_CONN_HOST_ERROR
+        case 2006:  // CR_SERVER_GONE_ERROR
+        case 2013:  // CR_SERVER_LOST
+            return Error::ConnectionLost;
+        case 1064:  // ER_PARSE_ERROR
+        case 1149:  // ER_SYNTAX_ERROR
+            return Error::SyntaxError;
+        case 1050:  // ER_TABLE_EXISTS_ERROR
+        case 1060:  // ER_DUP_FIELDNAME
+        case 1061:  // ER_DUP_KEYNAME
+        case 1826:  // ER_FK_DUP_NAME
+            return Error::DuplicateObject;
+        case 1051:  // ER_BAD_TABLE_ERROR
+        case 1054:  // ER_BAD_FIELD_ERROR
+        case 1091:  // ER_CANT_DROP_FIELD_OR_KEY
+        case 1146:  // ER_NO_SUCH_TABLE
+            return Error::UndefinedObject;
+        case 1048:  // ER_BAD_NULL_ERROR
+        case 1062:  // ER_DUP_ENTRY
+        case 1451:  // ER_ROW_IS_REFERENCED_2
+        case 1452:  // ER_NO_REFERENCED_ROW_2
+        case 3819:  // ER_CHECK_CONSTRAINT_VIOLATED
+            return Error::ConstraintViolation;
+        case 1044:  // ER_DBACCESS_DENIED_ERROR
+        case 1045:  // ER_ACCESS_DENIED_ERROR
+        case 1142:  // ER_TABLEACCESS_DENIED_ERROR
+        case 1227:  // ER_SPECIFIC_ACCESS_DENIED_ERROR
+            return Error::PermissionDenied;
+        default:
+            return Dialect::classifyError(error);
+        }
+    }
+
+    void renderModifyColumn(SqlBuilder &sql, const ColumnPrivate &column) const override
+    {
+        sql.word(QLatin1String("MODIFY COLUMN"));
+        column.renderDefinition(sql);
+    }
+
+    void renderDropKey(SqlBuilder &sql, const ColumnPrivate &key) const override
+    {
+        if (key.type == ColumnPrivate::PrimaryKey) {
+            sql.word(QLatin1String("DROP PRIMARY KEY"));
+        } else if (key.type == ColumnPrivate::ForeignKey) {
+            sql.word(QLatin1String("DROP FOREIGN KEY ")).identifier(key.name);
+        } else {
+            sql.word(QLatin1String("DROP INDEX ")).identifier(key.indexName.isEmpty() ? key.name : key.indexName);
+        }
+    }
+
+    void renderIndexParts(SqlBuilder &sql, const ColumnPrivate &key) const override
+    {
+        if (key.indexParts.empty()) {
+            sql.list(key.constraintCols);
+            return;
+        }
+
+        sql << QLatin1Char('(');
+        for (int i = 0; i < key.constraintCols.size(); ++i) {
+            if (i > 0) {
+                sql << QLatin1Char(',');
+            }
+            sql << key.constraintCols.at(i);
+            if (static_cast<std::size_t>(i) < key.indexParts.size()) {
+                const IndexPart &part = key.indexParts[static_cast<std::size_t>(i)];
+                if (part.length > 0) {
+                    sql << QLatin1Char('(');
+                    sql.number(part.length) << QLatin1Char(')');
+                }
+                if (part.descending) {
+                    sql << QLatin1String(" DESC");
+                }
+            }
+        }
+        sql << QLatin1Char(')');
+    }
+
+    bool definesPartitionsInline() const override { return true; }
+
+    void renderPartitionBy(SqlBuilder &sql, const TablePrivate &table) const override
+    {
+        switch (table.partitionType) {
+        case TablePrivate::RangePartitioning:
+            sql << QLatin1String("PARTITION BY RANGE COLUMNS ");
+            sql.list(table.partitionKey);
+            break;
+        case TablePrivate::ListPartitioning:
+            sql << QLatin1String("PARTITION BY LIST COLUMNS ");
+            sql.list(table.partitionKey);
+            break;
+        case TablePrivate::HashPartitioning:
+            sql << QLatin1String("PARTITION BY HASH ");
+            sql.list(table.partitionKey);
+            break;
+        case TablePrivate::KeyPartitioning:
+            sql << QLatin1String("PARTITION BY KEY ");
+            sql.list(table.partitionKey);
+            break;
+        default:
+            return;
+        }
+
+        if (table.partitionCount > 0) {
+            sql << QLatin1String(" PARTITIONS ");
+            sql.number(table.partitionCount);
+        }
+
+        if (!table.partitions.empty()) {
+            sql << QLatin1String(" (");
+            for (std::size_t i = 0; i < table.partitions.size(); ++i) {
+                if (i > 0) {
+                    sql << QLatin1String(", ");
+                }
+                renderPartition(sql, table, table.partitions.at(i));
+            }
+            sql << QLatin1Char(')');
+        }
+    }
+
+    void renderPartitionOperation(SqlBuilder &sql, const TablePrivate &table) const override
+    {
+        const PartitionPrivate &partition = table.partitions.front();
+        sql << QLatin1String("ALTER TABLE ");
+        sql.identifier(table.q_func()->objectName());
+
+        switch (partition.operation) {
+        case PartitionPrivate::AddPartition:
+            if (partition.reorganize.isEmpty()) {
+                sql << QLatin1String(" ADD PARTITION (");
+                renderPartition(sql, table, partition);
+            } else {
+                // partitions can not be added above a partition up to MAXVALUE
+                sql << QLatin1String(" REORGANIZE PARTITION ");
+                sql.identifier(partition.reorganize) << QLatin1String(" INTO (");
+                renderPartition(sql, table, partition);
+                sql << QLatin1String(", PARTITION ");
+                sql.identifier(partition.reorganize) << QLatin1String(" VALUES LESS THAN ");
+                renderRangeBound(sql, table, QVariant(), QLatin1String("MAXVALUE"));
+            }
+            sql << QLatin1Char(')');
+            break;
+        case PartitionPrivate::DropPartition:
+            sql << QLatin1String(" DROP PARTITION ");
+            sql.identifier(partition.name);
+            break;
+        case PartitionPrivate::TruncatePartition:
+            sql << QLatin1String(" TRUNCATE PARTITION ");
+            sql.identifier(partition.name);
+            break;
+        case PartitionPrivate::ExchangePartition:
+            sql << QLatin1String(" EXCHANGE PARTITION ");
+            sql.identifier(partition.name) << QLatin1String(" WITH TABLE ");
+            sql.identifier(partition.exchangeTable);
+            break;
+        case PartitionPrivate::DetachPartition:
+            if (detachesPartitions(table.dbVersion())) {
+                sql << QLatin1String(" CONVERT PARTITION ");
+                sql.identifier(partition.name) << QLatin1String(" TO TABLE ");
+                sql.identifier(partition.name);
+            } else {
+                qCWarning(FIR_CORE, "%s %s does not support detaching partitions. Can not detach \"%s\" from \"%s\".", qUtf8Printable(table.dbTypeToStr()), qUtf8Printable(table.dbVersion().toString()), qUtf8Printable(partition.name), qUtf8Printable(table.q_func()->objectName()));
+                sql.truncate(0);
+            }
+            break;
+        }
+    }
+
+    bool detachesPartitions(const QVersionNumber &version) const override
+    {
+        Q_UNUSED(version)
+        return false;
+    }
+
+    QString partitionsQuery() const override
+    {
+        return QStringLiteral("SELECT TABLE_NAME, PARTITION_NAME, PARTITION_DESCRIPTION = 'MAXVALUE' FROM information_schema.PARTITIONS "
+                              "WHERE TABLE_SCHEMA = DATABASE() AND PARTITION_NAME IS NOT NULL");
+    }
+
+protected:
+
+    static void renderPartition(SqlBuilder &sql, const TablePrivate &table, const PartitionPrivate &partition)
+    {
+        sql << QLatin1String("PARTITION ");
+        sql.identifier(partition.name);
+        switch (partition.kind) {
+        case PartitionPrivate::Range:
+            // ranges are only bounded by the upper value, the lower one is the bound of the previous partition
+            sql << QLatin1String(" VALUES LESS THAN ");
+            renderRangeBound(sql, table, partition.to, QLatin1String("MAXVALUE"));
+            break;
+        case PartitionPrivate::List:
+            sql << QLatin1String(" VALUES IN (");
+            renderPartitionValue(sql, partition.values);
+            sql << QLatin1Char(')');
+            break;
+        case PartitionPrivate::Default:
+            if (table.partitionType == TablePrivate::RangePartitioning) {
+                sql << QLatin1String(" VALUES LESS THAN ");
+                renderRangeBound(sql, table, QVariant(), QLatin1String("MAXVALUE"));
+            } else {
+                sql << QLatin1String(" DEFAULT");
+            }
+            break;
+        case PartitionPrivate::Hash:
+            break;
+        }
+    }
+
+    static Migrator::DatabaseFeatures commonFeatures()
+    {
+        Migrator::DatabaseFeatures f = Migrator::ForeignKeys;
+        f |= Migrator::CommentsOnColumns;
+        f |= Migrator::CommentsOnTables;
+        f |= Migrator::SetType;
+        f |= Migrator::EnumType;
+        f |= Migrator::UnsignedInteger;
+        f |= Migrator::CharsetOnColumn;
+        f |= Migrator::YearType;
+        f |= Migrator::Partitioning;
+        f |= Migrator::IndexPartOptions;
+        return f;
+    }
+};
+
+class MariaDbDialect : public MySqlDialect
+{
+public:
+    Migrator::DatabaseFeatures features(const QVersionNumber &version) const override
+    {
+        Migrator::DatabaseFeatures f = Migrator::NoFeatures;
+        if (version >= QVersionNumber(10,2,1)) {
+            f |= Migrator::DefValOnText;
+            f |= Migrator::DefValOnBlob;
+        }
+        if (version >= QVersionNumber(10,2,7)) {
+            f |= Migrator::JSONTypes;
+        }
+        return f | commonFeatures();
+    }
+
+    bool detachesPartitions(const QVersionNumber &version) const override
+    {
+        return version >= QVersionNumber(10,7);
+    }
+};
+
+class SqliteDialect : public Dialect
+{
+public:
+    Migrator::DatabaseFeatures features(const QVersionNumber &version) const override
+    {
+        Migrator::DatabaseFeatures f = Migrator::DefValOnText;
+        f |= Migrator::DefValOnBlob;
+        if (version >= QVersionNumber(3,6,19)) {
+            f |= Migrator::ForeignKeys;
+        }
+        if (version >= QVersionNumber(3,38,0)) {
+            f |= Migrator::JSONTypes;
+        }
+        return f;
+    }
+
+    const TypeMapping *typeMappings() const override { return sqliteTypes; }
+
+    void renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const override;
+
+    QLatin1String autoIncrementKeyword() const override { return QLatin1String("AUTOINCREMENT"); }
+    QLatin1String uniqueKeyword() const override { return QLatin1String("UNIQUE"); }
+
+    bool supportsTableOptions() const override { return false; }
+
+    QString migrationsTableQuery(const QString &migrationsTable) const override
+    {
+        return QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
+                              "migration TEXT NOT NULL UNIQUE, "
+                              "applied NUMERIC DEFAULT CURRENT_TIMESTAMP, "
+                              "checksum VARCHAR(32), "
+                              "source_checksum VARCHAR(32), "
+                              "execution_time INTEGER, "
+                              "batch INTEGER, "
+                              "phase INTEGER, "
+                              "progress INTEGER, "
+                              "lag_wait INTEGER)").arg(migrationsTable);
+    }
+
+    bool loadSchema(QSqlDatabase &db, Schema &schema, Error &error) const override
+    {
+        return loadSqliteSchema(db, schema, error);
+    }
+
+    QString lockTimeoutQuery(int msecs) const override
+    {
+        return QStringLiteral("PRAGMA busy_timeout = %1").arg(msecs);
+    }
+
+    QString currentLockTimeoutQuery() const override
+    {
+        return QStringLiteral("PRAGMA busy_timeout");
+    }
+
+    QString restoreLockTimeoutQuery(const QString &value) const override
+    {
+        return QStringLiteral("PRAGMA busy_timeout = %1").arg(value.toLongLong());
+    }
+
+    Error::Category classifyError(const QSqlError &error) const override
+    {
+        // primary result codes, extended result codes keep them in the lowest byte
+        switch (error.nativeErrorCode().toInt() & 0xff) {
+        case 5:     // SQLITE_BUSY
+        case 6:     // SQLITE_LOCKED
+            return Error::LockTimeout;
+        case 19:    // SQLITE_CONSTRAINT
+            return Error::ConstraintViolation;
+        case 9:     // SQLITE_INTERRUPT
+            return Error::Cancelled;
+        case 3:     // SQLITE_PERM
+        case 8:     // SQLITE_READONLY
+        case 23:    // SQLITE_AUTH
+            return Error::PermissionDenied;
+        case 14:    // SQLITE_CANTOPEN
+            return Error::ConnectionLost;
+        case 1:     // SQLITE_ERROR is used for all schema errors, only the message tells them apart
+        {
+            const QString text = error.databaseText();
+            if (text.contains(QLatin1String("syntax error")) || text.contains(QLatin1String("incomplete input"))) {
+                return Error::SyntaxError;
+            }
+            if (text.contains(QLatin1String("already exists")) || text.startsWith(QLatin1String("duplicate column name"))) {
+                return Error::DuplicateObject;
+            }
+            if (text.startsWith(QLatin1String("no such"))) {
+                return Error::UndefinedObject;
+            }
+            return Error::OtherCategory;
+        }
+        default:
+            return Dialect::classifyError(error);
+        }
+    }
+
+    bool supportsMultipleAlterClauses() const override { return false; }
+
+    void renderModifyColumn(SqlBuilder &sql, const ColumnPrivate &column) const override
+    {
+        Q_UNUSED(sql)
+        qCWarning(FIR_CORE, "SQLite does not support modifying column \"%s\".", qUtf8Printable(column.name));
+    }
+
+    void renderDropKey(SqlBuilder &sql, const ColumnPrivate &key) const override
+    {
+        Q_UNUSED(sql)
+        qCWarning(FIR_CORE, "SQLite does not support dropping indexes or constraints with ALTER TABLE. Can not drop \"%s\".", qUtf8Printable(key.indexName.isEmpty() ? key.name : key.indexName));
+    }
+
+    bool altersIndexesSeparately() const override { return true; }
+
+    bool checkAlterChange(const QString &table, const ColumnPrivate &change, Error &error) const override
+    {
+        const bool index = change.type == ColumnPrivate::Key || change.type == ColumnPrivate::UniqueKey;
+        if (change.operation == ColumnPrivate::ModifyColumn) {
+            error = Error(Error::InternalError, QStringLiteral("SQLite does not support modifying column \"%1\" of the existing table \"%2\".").arg(change.name, table));
+            return false;
+        }
+        if (change.operation == ColumnPrivate::AddColumn && change.type >= ColumnPrivate::Key && !index) {
+            error = Error(Error::InternalError, QStringLiteral("SQLite does not support adding primary keys or constraints to the existing table \"%1\".").arg(table));
+            return false;
+        }
+        // indexes created for constraints have no name of their own and can not be dropped
+        if (change.operation == ColumnPrivate::DropColumn && change.type >= ColumnPrivate::Key && (!index || change.indexName.isEmpty())) {
+            error = Error(Error::InternalError, QStringLiteral("SQLite does not support dropping primary keys or constraints from the existing table \"%1\".").arg(table));
+            return false;
+        }
+        return true;
+    }
+};
+
+class PsqlDialect : public Dialect
+{
+public:
+    Migrator::DatabaseFeatures features(const QVersionNumber &version) const override
+    {
+        Migrator::DatabaseFeatures f = Migrator::DefValOnText;
+        f |= Migrator::DefValOnBlob;
+        f |= Migrator::DefValOnGeometry;
+        f |= Migrator::JSONTypes;
+        f |= Migrator::GeometryTypes;
+        f |= Migrator::XMLType;
+        f |= Migrator::NetworkAddressTypes;
+        f |= Migrator::MonetaryTypes;
+        f |= Migrator::ForeignKeys;
+        f |= Migrator::CommentsOnColumns;
+        f |= Migrator::CommentsOnTables;
+        f |= Migrator::SetType;
+        f |= Migrator::EnumType;
+        // declarative partitioning
+        if (version >= QVersionNumber(10)) {
+            f |= Migrator::Partitioning;
+        }
+        return f;
+    }
+
+    QString partitionsQuery() const override
+    {
+        // new partitions are attached next to a default partition
+        return QStringLiteral("SELECT p.relname, c.relname, false FROM pg_inherits i "
+                              "JOIN pg_class c ON c.oid = i.inhrelid "
+                              "JOIN pg_class p ON p.oid = i.inhparent "
+                              "WHERE p.relkind = 'p' AND p.relnamespace = current_schema()::regnamespace");
+    }
+
+    const TypeMapping *typeMappings() const override { return psqlTypes; }
+
+    QString migrationsTableQuery(const QString &migrationsTable) const override
+    {
+        return QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
+                              "migration VARCHAR(255) NOT NULL,"
+                              "applied TIMESTAMP NOT NULL DEFAULT now(),"
+                              "checksum VARCHAR(32),"
+                              "source_checksum VARCHAR(32),"
+                              "execution_time INTEGER,"
+                              "batch INTEGER,"
+                              "phase INTEGER,"
+                              "progress INTEGER,"
+                              "lag_wait INTEGER,"
+                              "UNIQUE (migration))").arg(migrationsTable);
+    }
+
+    bool loadSchema(QSqlDatabase &db, Schema &schema, Error &error) const override
+    {
+        return loadPsqlSchema(db, schema, error);
+    }
+
+    QString lockTimeoutQuery(int msecs) const override
+    {
+        // SET LOCAL would require a transaction around every migration, so the session value is set and reset afterwards
+        return QStringLiteral("SET lock_timeout = '%1ms'").arg(msecs);
+    }
+
+    QString currentLockTimeoutQuery() const override
+    {
+        return QStringLiteral("SELECT current_setting('lock_timeout')");
+    }
+
+    QString restoreLockTimeoutQuery(const QString &value) const override
+    {
+        // the setting keeps its unit, like 5s
+        SqlBuilder sql(this, 32 + value.size());
+        sql << QLatin1String("SET lock_timeout = ");
+        sql.stringLiteral(value);
+        return sql.take();
+    }
+
+    QString connectionIdQuery() const override
+    {
+        return QStringLiteral("SELECT pg_backend_pid()");
+    }
+
+    QString cancelQuery(const QString &id) const override
+    {
+        return QStringLiteral("SELECT pg_cancel_backend(%1)").arg(id);
+    }
+};
+
+void MySqlDialect::renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const
+{
+    const QString defValStr = column.defVal.toString();
+    if (defValStr.startsWith(QLatin1Char('(')) && defValStr.endsWith(QLatin1Char(')'))) {
+        sql << defValStr;
+        return;
+    }
+    if (defValStr.compare(QLatin1String("NULL"), Qt::CaseInsensitive) == 0) {
+        if (column._nullable) {
+            sql << defValStr;
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value NULL for column" << column.name << "of type" << column.typeString() << ": not nullable";
+        }
+        return;
+    }
+
+    if (column.type < ColumnPrivate::Bit) { // numeric columns
+        bool isDouble = false;
+        bool isInteger = false;
+        column.defVal.toDouble(&isDouble);
+        column.defVal.toLongLong(&isInteger);
+        if ((isDouble || isInteger) && column.defVal.canConvert<QString>()) {
+            sql << defValStr;
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::Bit) {
+        if (column.defVal.canConvert<QBitArray>()) {
+            const QBitArray ba = column.defVal.toBitArray();
+            if (!ba.isEmpty()) {
+                int length = ba.size();
+                if (length > 63) {
+                    length = 63;
+                }
+                sql << QLatin1String("b'");
+                for (int i = 0; i < length; ++i) {
+                    sql << (ba.at(i) ? QLatin1Char('1') : QLatin1Char('0'));
+                }
+                sql << QLatin1Char('\'');
+            }
+        } else if (column.defVal.canConvert<QString>()) {
+            if (!defValStr.startsWith(QLatin1String("b'"))) {
+                sql << QLatin1String("b'");
+            }
+            sql << defValStr;
+            if (!defValStr.endsWith(QLatin1Char('\''))) {
+                sql << QLatin1Char('\'');
+            }
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::Date) {
+        if (column.defVal.canConvert<QDate>()) {
+            sql.stringLiteral(column.defVal.toDate().toString(Qt::ISODate));
+        } else if (column.defVal.canConvert<QString>()) {
+            sql.stringLiteral(defValStr);
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::DateTime || column.type == ColumnPrivate::Timestamp) {
+        if (column.defVal.type() == QMetaType::QDateTime) {
+            sql.stringLiteral(column.defVal.toDateTime().toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")));
+        } else if (column.defVal.canConvert<QString>()) {
+            if (defValStr.compare(QLatin1String("CURRENT_TIMESTAMP"), Qt::CaseInsensitive) == 0) {
+                sql << defValStr;
+            } else {
+                sql.stringLiteral(defValStr);
+            }
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::Time) {
+        if (column.defVal.canConvert<QTime>()) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
+            sql.stringLiteral(column.defVal.toTime().toString(Qt::ISODateWithMs));
+#else
+            sql.stringLiteral(column.defVal.toTime().toString(QStringLiteral("HH:MM:ss.zzz")));
+#endif
+        } else if (column.defVal.canConvert<QString>()) {
+            sql.stringLiteral(defValStr);
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::Year) {
+        if (column.defVal.canConvert<QString>()) {
+            sql.stringLiteral(defValStr);
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type > ColumnPrivate::Year && column.type < ColumnPrivate::TinyBlob) { // binay type columns
+        if (column.defVal.canConvert<QString>()) {
+            sql.stringLiteral(defValStr);
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type >= ColumnPrivate::TinyBlob && column.type <= ColumnPrivate::LongBlob) { // blob type columns
+        if (column.defVal.canConvert<QByteArray>()) {
+            const QByteArray hex = column.defVal.toByteArray().toHex();
+            sql << QLatin1String("('0x") << QLatin1String(hex.constData(), hex.size()) << QLatin1String("')");
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type >= ColumnPrivate::Char && column.type <= ColumnPrivate::Json) { // char and text type columns
+        if (column.defVal.canConvert<QString>()) {
+            sql << QLatin1Char('(');
+            sql.stringLiteral(defValStr) << QLatin1Char(')');
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type == ColumnPrivate::Boolean) {
+        if (column.defVal.canConvert<bool>()) {
+            sql << (column.defVal.toBool() ? QLatin1Char('1') : QLatin1Char('0'));
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    }
+}
+
+void SqliteDialect::renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const
+{
+    const QString defValStr = column.defVal.toString();
+    if (!defValStr.isEmpty()) {
+        if (defValStr.compare(QLatin1String("CURRENT_TIME"), Qt::CaseInsensitive) == 0 || defValStr.compare(QLatin1String("CURRENT_DATE"), Qt::CaseInsensitive) == 0 || defValStr.compare(QLatin1String("CURRENT_TIMESTAMP"), Qt::CaseInsensitive) == 0) {
+            sql << defValStr;
+            return;
+        }
+        if (defValStr.compare(QLatin1String("NULL"), Qt::CaseInsensitive) == 0) {
+            if (column._nullable) {
+                sql << defValStr;
+            } else {
+                qCWarning(FIR_CORE) << "Invalid default value NULL for column" << column.name << "of type" << column.typeString() << ": not nullable";
+            }
+            return;
+        }
+    }
+
+    if (defValStr.startsWith(QLatin1Char('(')) && defValStr.endsWith(QLatin1Char(')'))) {
+        sql << defValStr;
+        return;
+    }
+
+    if (column.type < ColumnPrivate::Bit) { // numeric values
+        bool isInteger = false;
+        bool isDouble = false;
+        column.defVal.toLongLong(&isInteger);
+        column.defVal.toDouble(&isDouble);
+        if (isInteger || isDouble) {
+            sql << defValStr;
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if (column.type >= ColumnPrivate::TinyBlob && column.type <= ColumnPrivate::LongBlob) {
+        if (defValStr.startsWith(QLatin1String("x'")) && defValStr.endsWith(QLatin1Char('\''))) {
+            sql << defValStr;
+        } else if (column.defVal.canConvert<QByteArray>()) {
+            const QByteArray hex = column.defVal.toByteArray().toHex();
+            sql << QLatin1String("x'") << QLatin1String(hex.constData(), hex.size()) << QLatin1Char('\'');
+        } else {
+            qCWarning(FIR_CORE) << "Invalid default value for column" << column.name << "of type" << column.typeString() << ":" << column.defVal;
+        }
+    } else if ((column.type == ColumnPrivate::Binary || column.type == ColumnPrivate::VarBinary || (column.type >= ColumnPrivate::Char && column.type <= ColumnPrivate::LongText)) && column.defVal.canConvert<QString>()) {
+        sql.stringLiteral(defValStr);
+    }
+}
+
+}
+
+const Dialect *Dialect::forType(Migrator::DatabaseType type)
+{
+    static const Dialect generic{};
+    static const MySqlDialect mysql{};
+    static const MariaDbDialect mariadb{};
+    static const SqliteDialect sqlite{};
+    static const PsqlDialect psql{};
+
+    switch (type) {
+    case Migrator::MySQL:
+        return &mysql;
+    case Migrator::MariaDB:
+        return &mariadb;
+    case Migrator::SQLite:
+        return &sqlite;
+    case Migrator::PSQL:
+        return &psql;
+    default:
+        return &generic;
+    }
+}
+
+Migrator::DatabaseFeatures Dialect::features(const QVersionNumber &version) const
+{
+    Q_UNUSED(version)
+    return Migrator::NoFeatures;
+}
+
+const TypeMapping *Dialect::typeMappings() const
+{
+    return nullptr;
+}
+
+void Dialect::renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const
+{
+    Q_UNUSED(sql)
+    Q_UNUSED(column)
+}
+
+QChar Dialect::identifierQuote() const
+{
+    return QLatin1Char('"');
+}
+
+bool Dialect::backslashEscapes() const
+{
+    return false;
+}
+
+QLatin1String Dialect::autoIncrementKeyword() const
+{
+    return QLatin1String("AUTO_INCREMENT");
+}
+
+QLatin1String Dialect::uniqueKeyword() const
+{
+    return QLatin1String("UNIQUE KEY");
+}
+
+bool Dialect::supportsTableOptions() const
+{
+    return true;
+}
+
+bool Dialect::supportsMultipleAlterClauses() const
+{
+    return true;
+}
+
+void Dialect::renderModifyColumn(SqlBuilder &sql, const ColumnPrivate &column) const
+{
+    sql.word(QLatin1String("ALTER COLUMN ")).identifier(column.name) << QLatin1String(" TYPE ");
+    column.renderType(sql);
+
+    sql << QLatin1String(", ALTER COLUMN ");
+    sql.identifier(column.name) << ((column._nullable && !column._primaryKey) ? QLatin1String(" DROP NOT NULL") : QLatin1String(" SET NOT NULL"));
+
+    // the default of auto increment columns is maintained by the database
+    if (column._autoIncrement) {
+        return;
+    }
+
+    const SqlBuilder::size_type defStart = sql.size();
+    sql << QLatin1String(", ALTER COLUMN ");
+    sql.identifier(column.name);
+    if (column.defVal.isNull()) {
+        sql << QLatin1String(" DROP DEFAULT");
+        return;
+    }
+
+    sql << QLatin1String(" SET DEFAULT ");
+    const SqlBuilder::size_type valStart = sql.size();
+    column.renderDefVal(sql);
+    // a default that can not be rendered is left as it is
+    if (sql.size() == valStart) {
+        sql.truncate(defStart);
+    }
+}
+
+void Dialect::renderDropKey(SqlBuilder &sql, const ColumnPrivate &key) const
+{
+    const QString name = key.name.isEmpty() ? key.indexName : key.name;
+    if (name.isEmpty()) {
+        qCWarning(FIR_CORE, "Can not drop an index or constraint without name.");
+        return;
+    }
+    sql.word(QLatin1String("DROP CONSTRAINT ")).identifier(name);
+}
+
+void Dialect::renderIndexParts(SqlBuilder &sql, const ColumnPrivate &key) const
+{
+    sql.list(key.constraintCols);
+}
+
+bool Dialect::altersIndexesSeparately() const
+{
+    return false;
+}
+
+void Dialect::renderCreateIndex(SqlBuilder &sql, const QString &table, const ColumnPrivate &key) const
+{
+    QString name = key.indexName.isEmpty() ? key.name : key.indexName;
+    if (name.isEmpty()) {
+        name = table % QLatin1Char('_') % key.constraintCols.join(QLatin1Char('_')) % (key.type == ColumnPrivate::UniqueKey ? QLatin1String("_key") : QLatin1String("_idx"));
+    }
+    sql << (key.type == ColumnPrivate::UniqueKey ? QLatin1String("CREATE UNIQUE INDEX ") : QLatin1String("CREATE INDEX "));
+    sql.identifier(name) << QLatin1String(" ON ");
+    sql.identifier(table) << QLatin1Char(' ');
+    renderIndexParts(sql, key);
+}
+
+void Dialect::renderDropIndex(SqlBuilder &sql, const ColumnPrivate &key) const
+{
+    sql << QLatin1String("DROP INDEX ");
+    sql.identifier(key.indexName.isEmpty() ? key.name : key.indexName);
+}
+
+bool Dialect::checkAlterChange(const QString &table, const ColumnPrivate &change, Error &error) const
+{
+    Q_UNUSED(table)
+    Q_UNUSED(change)
+    Q_UNUSED(error)
+    return true;
+}
+
+bool Dialect::definesPartitionsInline() const
+{
+    return false;
+}
+
+void Dialect::renderPartitionBy(SqlBuilder &sql, const TablePrivate &table) const
+{
+    switch (table.partitionType) {
+    case TablePrivate::RangePartitioning:
+        sql << QLatin1String("PARTITION BY RANGE ");
+        sql.list(table.partitionKey);
+        break;
+    case TablePrivate::ListPartitioning:
+        sql << QLatin1String("PARTITION BY LIST ");
+        sql.list(table.partitionKey);
+        break;
+    case TablePrivate::HashPartitioning:
+    case TablePrivate::KeyPartitioning:
+        sql << QLatin1String("PARTITION BY HASH ");
+        sql.list(table.partitionKey);
+        break;
+    default:
+        break;
+    }
+}
+
+void Dialect::renderPartitionOperation(SqlBuilder &sql, const TablePrivate &table) const
+{
+    const PartitionPrivate &partition = table.partitions.front();
+    const QString parent = table.q_func()->objectName();
+
+    switch (partition.operation) {
+    case PartitionPrivate::AddPartition:
+        sql << QLatin1String("CREATE TABLE ");
+        sql.identifier(partition.name) << QLatin1String(" PARTITION OF ");
+        sql.identifier(parent);
+        switch (partition.kind) {
+        case PartitionPrivate::Range:
+            sql << QLatin1String(" FOR VALUES FROM ");
+            renderRangeBound(sql, table, partition.from, QLatin1String("MINVALUE"));
+            sql << QLatin1String(" TO ");
+            renderRangeBound(sql, table, partition.to, QLatin1String("MAXVALUE"));
+            break;
+        case PartitionPrivate::List:
+            sql << QLatin1String(" FOR VALUES IN (");
+            renderPartitionValue(sql, partition.values);
+            sql << QLatin1Char(')');
+            break;
+        case PartitionPrivate::Hash:
+            sql << QLatin1String(" FOR VALUES WITH (MODULUS ");
+            sql.number(partition.modulus) << QLatin1String(", REMAINDER ");
+            sql.number(partition.remainder) << QLatin1Char(')');
+            break;
+        case PartitionPrivate::Default:
+            sql << QLatin1String(" DEFAULT");
+            break;
+        }
+        break;
+    case PartitionPrivate::DropPartition:
+        sql << QLatin1String("DROP TABLE ");
+        sql.identifier(partition.name);
+        break;
+    case PartitionPrivate::DetachPartition:
+        sql << QLatin1String("ALTER TABLE ");
+        sql.identifier(parent) << QLatin1String(" DETACH PARTITION ");
+        sql.identifier(partition.name);
+        break;
+    case PartitionPrivate::TruncatePartition:
+        sql << QLatin1String("TRUNCATE TABLE ");
+        sql.identifier(partition.name);
+        break;
+    case PartitionPrivate::ExchangePartition:
+    {
+        // there is no EXCHANGE PARTITION, so the other table is attached with the bound of the detached partition
+        SqlBuilder parentName(this);
+        parentName.identifier(parent);
+        SqlBuilder partitionName(this);
+        partitionName.identifier(partition.name);
+        SqlBuilder exchangeName(this);
+        exchangeName.identifier(partition.exchangeTable);
+        const QString parentStr = parentName.take();
+        const QString partitionStr = partitionName.take();
+        const QString exchangeStr = exchangeName.take();
+
+        sql << QLatin1String("DO $$DECLARE bound text; BEGIN SELECT pg_get_expr(relpartbound, oid) INTO bound FROM pg_class WHERE oid = ");
+        sql.stringLiteral(partitionStr) << QLatin1String("::regclass; EXECUTE ");
+        sql.stringLiteral(QLatin1String("ALTER TABLE ") % parentStr % QLatin1String(" DETACH PARTITION ") % partitionStr) << QLatin1String("; EXECUTE ");
+        sql.stringLiteral(QLatin1String("ALTER TABLE ") % parentStr % QLatin1String(" ATTACH PARTITION ") % exchangeStr % QLatin1Char(' ')) << QLatin1String(" || bound; END$$");
+        break;
+    }
+    }
+}
+
+bool Dialect::detachesPartitions(const QVersionNumber &version) const
+{
+    Q_UNUSED(version)
+    return true;
+}
+
+QString Dialect::partitionsQuery() const
+{
+    return QString();
+}
+
+QString Dialect::migrationsTableQuery(const QString &migrationsTable) const
+{
+    return QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
+                          "migration VARCHAR(255) NOT NULL, "
+                          "applied TIMESTAMP DEFAULT CURRENT_TIMESTAMP, "
+                          "checksum VARCHAR(32), "
+                          "source_checksum VARCHAR(32), "
+                          "execution_time INTEGER, "
+                          "batch INTEGER, "
+                          "phase INTEGER, "
+                          "progress INTEGER, "
+                          "lag_wait INTEGER, "
+                          "UNIQUE (migration))").arg(migrationsTable);
+}
+
+QString Dialect::lockTimeoutQuery(int msecs) const
+{
+    Q_UNUSED(msecs)
+    return QString();
+}
+
+QString Dialect::currentLockTimeoutQuery() const
+{
+    return QString();
+}
+
+QString Dialect::restoreLockTimeoutQuery(const QString &value) const
+{
+    Q_UNUSED(value)
+    return QString();
+}
+
+Error::Category Dialect::classifyError(const QSqlError &error) const
+{
+    const QString state = error.nativeErrorCode();
+    if (state.size() == 5) {
+        if (state == QLatin1String("40P01") || state == QLatin1String("40001")) {
+            // deadlock_detected, serialization_failure
+            return Error::Deadlock;
+        }
+        if (state == QLatin1String("55P03")) {
+            // lock_not_available
+            return Error::LockTimeout;
+        }
+        if (state.startsWith(QLatin1String("08")) || state == QLatin1String("57P01") || state == QLatin1String("57P02") || state == QLatin1String("57P03")) {
+            // connection_exception, admin_shutdown, crash_shutdown, cannot_connect_now
+            return Error::ConnectionLost;
+        }
+        if (state == QLatin1String("42601")) {
+            return Error::SyntaxError;
+        }
+        if (state == QLatin1String("42P07") || state == QLatin1String("42701") || state == QLatin1String("42710") || state == QLatin1String("42P06")) {
+            // duplicate_table, duplicate_column, duplicate_object, duplicate_schema
+            return Error::DuplicateObject;
+        }
+        if (state == QLatin1String("42P01") || state == QLatin1String("42703") || state == QLatin1String("42704")) {
+            // undefined_table, undefined_column, undefined_object
+            return Error::UndefinedObject;
+        }
+        if (state.startsWith(QLatin1String("23"))) {
+            return Error::ConstraintViolation;
+        }
+        if (state == QLatin1String("42501")) {
+            return Error::PermissionDenied;
+        }
+        if (state == QLatin1String("57014")) {
+            // query_canceled
+            return Error::Cancelled;
+        }
+    }
+
+    if (error.type() == QSqlError::ConnectionError) {
+        return Error::ConnectionLost;
+    }
+
+    return error.type() == QSqlError::NoError ? Error::Unclassified : Error::OtherCategory;
+}
+
+QString Dialect::connectionIdQuery() const
+{
+    return QString();
+}
+
+QString Dialect::cancelQuery(const QString &id) const
+{
+    Q_UNUSED(id)
+    return QString();
+}
+
+bool Dialect::loadSchema(QSqlDatabase &db, Schema &schema, Error &error) const
+{
+    Q_UNUSED(db)
+    error = Error(Error::InternalError, QStringLiteral("Reading the database schema is not supported for %1 databases.").arg(schema.context.typeToStr()));
+    qCCritical(FIR_CORE) << error;
+    return false;
+}
@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_DIALECT_P_H
+#define FIRFUORIDA_DIALECT_P_H
+
+#include "migrator.h"
+#include "error.h"
+#include <QString>
+#include <QVersionNumber>
+
+class QSqlDatabase;
+class QSqlError;
+
+namespace Firfuorida {
+
+class SqlBuilder;
+class ColumnPrivate;
+class TablePrivate;
+class Schema;
+
+/*!
+ * \internal
+ * \brief Describes which parameters are appended to a mapped type name.
+ */
+enum class TypeParams : quint8 {
+    None,
+    DisplayWidth,
+    PrecisionScale,
+    Length,
+    Values,
+    Unsupported
+};
+
+/*!
+ * \internal
+ * \brief Maps a ColumnPrivate::Type to the type name used by a dialect.
+ *
+ * A \c nullptr name means that nothing is rendered for the type.
+ */
+struct TypeMapping {
+    quint8 type;
+    const char *name;
+    TypeParams params;
+};
+
+/*!
+ * \internal
+ * \brief Encapsulates everything that differs between the supported database systems.
+ *
+ * The dialect is resolved once by Migrator::initDatabase() from the database
+ * type and stored in the DbContext that is shared with tables and columns.
+ * Rendering code asks the dialect instead of branching on the database type.
+ * The base implementation is used for database systems without a dedicated
+ * dialect and sticks to plain SQL.
+ */
+class Dialect
+{
+public:
+    virtual ~Dialect() = default;
+
+    /*!
+     * \brief Returns the dialect for \a type, never returns a \c nullptr.
+     */
+    static const Dialect *forType(Migrator::DatabaseType type);
+
+    /*!
+     * \brief Returns the features supported by database \a version.
+     */
+    virtual Migrator::DatabaseFeatures features(const QVersionNumber &version) const;
+
+    /*!
+     * \brief Returns the type mapping table with ColumnPrivate::TypeCount entries or \c nullptr.
+     */
+    virtual const TypeMapping *typeMappings() const;
+
+    /*!
+     * \brief Appends the DEFAULT value of \a column, appends nothing for invalid values.
+     */
+    virtual void renderDefVal(SqlBuilder &sql, const ColumnPrivate &column) const;
+
+    virtual QChar identifierQuote() const;
+    virtual bool backslashEscapes() const;
+
+    virtual QLatin1String autoIncrementKeyword() const;
+    virtual QLatin1String uniqueKeyword() const;
+
+    /*!
+     * \brief Returns \c true if ENGINE, CHARSET and COLLATE can be set on tables.
+     */
+    virtual bool supportsTableOptions() const;
+
+    /*!
+     * \brief Returns \c true if a single ALTER TABLE statement can contain multiple changes.
+     */
+    virtual bool supportsMultipleAlterClauses() const;
+
+    /*!
+     * \brief Appends the ALTER TABLE clauses that change \a column to its current definition.
+     */
+    virtual void renderModifyColumn(SqlBuilder &sql, const ColumnPrivate &column) const;
+
+    /*!
+     * \brief Appends the ALTER TABLE clause that drops the index, key or foreign key \a key.
+     */
+    virtual void renderDropKey(SqlBuilder &sql, const ColumnPrivate &key) const;
+
+    /*!
+     * \brief Appends the parenthesized columns of the index or key \a key.
+     */
+    virtual void renderIndexParts(SqlBuilder &sql, const ColumnPrivate &key) const;
+
+    /*!
+     * \brief Returns \c true if plain and unique indexes of existing tables are created
+     * and dropped by statements of their own instead of ALTER TABLE.
+     */
+    virtual bool altersIndexesSeparately() const;
+
+    /*!
+     * \brief Appends the CREATE INDEX statement that adds the plain or unique index \a key to \a table.
+     *
+     * Indexes without a name get one generated from the table and column names.
+     */
+    virtual void renderCreateIndex(SqlBuilder &sql, const QString &table, const ColumnPrivate &key) const;
+
+    /*!
+     * \brief Appends the DROP INDEX statement that removes the plain or unique index \a key.
+     */
+    virtual void renderDropIndex(SqlBuilder &sql, const ColumnPrivate &key) const;
+
+    /*!
+     * \brief Returns \c true if \a change can be applied to the existing \a table, otherwise sets \a error.
+     */
+    virtual bool checkAlterChange(const QString &table, const ColumnPrivate &change, Error &error) const;
+
+    /*!
+     * \brief Returns \c true if partitions are defined by the statements of the partitioned table itself.
+     *
+     * Otherwise every partition is a table of its own that is created and changed by
+     * separate statements, as on PostgreSQL.
+     */
+    virtual bool definesPartitionsInline() const;
+
+    /*!
+     * \brief Appends the PARTITION BY clause of \a table, including inline partition definitions.
+     */
+    virtual void renderPartitionBy(SqlBuilder &sql, const TablePrivate &table) const;
+
+    /*!
+     * \brief Appends the statement for the single partition operation of the PartitionTable \a table.
+     */
+    virtual void renderPartitionOperation(SqlBuilder &sql, const TablePrivate &table) const;
+
+    /*!
+     * \brief Returns \c true if partitions can be detached on the database system in \a version.
+     */
+    virtual bool detachesPartitions(const QVersionNumber &version) const;
+
+    /*!
+     * \brief Returns the query that selects the partitions of all tables in the current schema.
+     *
+     * Selects table name, partition name and if new range partitions have to be split off
+     * from the partition, because it is the catch-all partition up to MAXVALUE. Returns
+     * an empty string if the database system does not support partitioning.
+     */
+    virtual QString partitionsQuery() const;
+
+    /*!
+     * \brief Returns the statement that creates the table keeping track of applied migrations.
+     */
+    virtual QString migrationsTableQuery(const QString &migrationsTable) const;
+
+    /*!
+     * \brief Reads all tables of the current schema of \a db into \a schema.
+     *
+     * Implementations use a fixed number of bulk queries, independent of the
+     * number of tables.
+     */
+    virtual bool loadSchema(QSqlDatabase &db, Schema &schema, Error &error) const;
+
+    /*!
+     * \brief Returns the statement that limits the time to wait for locks to \a msecs milliseconds.
+     *
+     * Returns an empty string if the database system does not support it.
+     */
+    virtual QString lockTimeoutQuery(int msecs) const;
+
+    /*!
+     * \brief Returns the query for the lock timeout of the session, saved before lockTimeoutQuery().
+     */
+    virtual QString currentLockTimeoutQuery() const;
+
+    /*!
+     * \brief Returns the statement that restores the lock timeout \a value returned by currentLockTimeoutQuery().
+     */
+    virtual QString restoreLockTimeoutQuery(const QString &value) const;
+
+    /*!
+     * \brief Returns the category of \a error from its native error code.
+     *
+     * The base implementation interprets the native error code as SQLSTATE, as used by
+     * PostgreSQL and ODBC drivers.
+     */
+    virtual Error::Category classifyError(const QSqlError &error) const;
+
+    /*!
+     * \brief Returns the query that selects the id of the server process serving the connection.
+     *
+     * Returns an empty string if statements can not be cancelled from another connection.
+     */
+    virtual QString connectionIdQuery() const;
+
+    /*!
+     * \brief Returns the statement that cancels the statement currently executed by the connection \a id.
+     *
+     * The statement is executed on another connection, \a id has been returned by connectionIdQuery().
+     */
+    virtual QString cancelQuery(const QString &id) const;
+};
+
+}
+
+#endif // FIRFUORIDA_DIALECT_P_H
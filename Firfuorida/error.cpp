@@ -25,6 +25,12 @@ Error::Error(const QSqlError &sqlError, const QString &text) :
 
 }
 
+Error::Error(const QSqlError &sqlError, const QString &text, Category category) :
+    d(new ErrorData(sqlError, text, category))
+{
+
+}
+
 Error::Error(const Error &other) = default;
 
 Error::Error(Error &&error) noexcept = default;
@@ -59,6 +65,23 @@ QSqlError Error::sqlError() const
     return d->sqlError;
 }
 
+Error::Category Error::category() const
+{
+    return d->category;
+}
+
+bool Error::isTransient() const
+{
+    switch (d->category) {
+    case Deadlock:
+    case LockTimeout:
+    case ConnectionLost:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool Error::operator==(const Error &other) const noexcept
 {
     if (type() != other.type()) {
@@ -70,6 +93,9 @@ bool Error::operator==(const Error &other) const noexcept
     if (sqlError() != other.sqlError()) {
         return false;
     }
+    if (category() != other.category()) {
+        return false;
+    }
     return true;
 }
 
@@ -40,6 +40,28 @@ public:
         UnknownError    = 255   /**< An unknown error occured. */
     };
 
+    /*!
+     * \brief This enum type describes the cause of an SqlError.
+     *
+     * The category is determined from the native error code or the SQLSTATE reported by
+     * the database driver. Deadlock, LockTimeout and ConnectionLost are transient, a
+     * statement that failed with one of them can succeed if it is executed again.
+     * \sa isTransient()
+     */
+    enum Category : uint8_t {
+        Unclassified        = 0,    /**< The error has not been classified. */
+        Deadlock            = 1,    /**< A deadlock or a serialization failure has been detected. */
+        LockTimeout         = 2,    /**< Waiting for a lock timed out. */
+        ConnectionLost      = 3,    /**< The connection to the database server failed or has been lost. */
+        SyntaxError         = 4,    /**< The statement contains a syntax error. */
+        DuplicateObject     = 5,    /**< A table, column, index or constraint already exists. */
+        UndefinedObject     = 6,    /**< A table, column, index or constraint does not exist. */
+        ConstraintViolation = 7,    /**< Data violates a NOT NULL, UNIQUE, CHECK or foreign key constraint. */
+        PermissionDenied    = 8,    /**< The database user lacks the required privileges. */
+        Cancelled           = 9,    /**< The migration has been cancelled or timed out, see Migrator::cancel(). */
+        OtherCategory       = 255   /**< The error does not belong to any other category. */
+    };
+
     /*!
      * \brief Constructs a new %Error object of type NoError.
      */
@@ -57,6 +79,13 @@ public:
      */
     Error(const QSqlError &sqlError, const QString &text);
 
+    /*!
+     * \brief Constucts a new %Error object with given \a sqlError, \a text and \a category.
+     *
+     * The type() will automatically set to SqlError.
+     */
+    Error(const QSqlError &sqlError, const QString &text, Category category);
+
     /*!
      * \brief Constructs a copy of \a other.
      */
@@ -100,6 +129,16 @@ public:
      */
     QSqlError sqlError() const;
 
+    /*!
+     * \brief Returns the category of an SqlError.
+     */
+    Category category() const;
+
+    /*!
+     * \brief Returns \c true if the error is of a transient category and the failed operation can be retried.
+     */
+    bool isTransient() const;
+
     /*!
      * \brief Returns \c true if \a this and \a other have the same content; otherwise returns \c false.
      */
@@ -22,10 +22,11 @@ public:
         type(_type)
     {}
 
-    ErrorData(const QSqlError &_sqlError, const QString &_text) :
+    ErrorData(const QSqlError &_sqlError, const QString &_text, Error::Category _category = Error::Unclassified) :
         QSharedData(),
         sqlError(_sqlError),
-        text(_text)
+        text(_text),
+        category(_category)
     {
         type = Error::SqlError;
     }
@@ -35,6 +36,7 @@ public:
     QSqlError sqlError;
     QString text;
     Error::ErrorType type = Error::NoError;
+    Error::Category category = Error::Unclassified;
 };
 
 }
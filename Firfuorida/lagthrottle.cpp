@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "lagthrottle_p.h"
+#include "backgroundworker_p.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QThread>
+#include "logging.h"
+
+using namespace Firfuorida;
+
+namespace {
+
+QString lagConnectionPrefix()
+{
+    return QStringLiteral("firfuorida-lag-%1-").arg(reinterpret_cast<quintptr>(QThread::currentThread()), 0, 16);
+}
+
+}
+
+qint64 LagThrottle::wait(const QSqlDatabase &db, const std::function<bool()> &interrupted)
+{
+    if (!probe || (m_lastCheck.isValid() && m_lastCheck.elapsed() < pollInterval)) {
+        return 0;
+    }
+
+    QElapsedTimer timer;
+    for (;;) {
+        const qint64 lag = probe(db);
+        m_lastCheck.start();
+        // an unknown lag might be a replica that has stopped replicating, so it pauses as well
+        if ((lag >= 0 && lag <= maxLag) || (interrupted && interrupted())) {
+            break;
+        }
+        if (!timer.isValid()) {
+            if (lag < 0) {
+                qCWarning(FIR_CORE, "Replication lag is unknown, pausing migration");
+            } else {
+                qCInfo(FIR_CORE, "Replication lag of %lli ms exceeds %lli ms, pausing migration", lag, maxLag);
+            }
+            timer.start();
+        }
+        QThread::msleep(static_cast<unsigned long>(pollInterval));
+    }
+
+    if (!timer.isValid()) {
+        return 0;
+    }
+
+    const qint64 waited = timer.elapsed();
+    qCInfo(FIR_CORE, "Resuming migration after waiting %lli ms for replicas to catch up", waited);
+    return waited;
+}
+
+qint64 Firfuorida::replicaStatusLag(const BackgroundConnection &replica, const QString &name)
+{
+    const QString connectionName = lagConnectionPrefix() + name;
+    QSqlDatabase db = QSqlDatabase::contains(connectionName) ? QSqlDatabase::database(connectionName) : replica.open(connectionName);
+    if (!db.isOpen()) {
+        qCWarning(FIR_CORE) << Error(db.lastError(), QStringLiteral("Can not open connection to replica \"%1\" to measure the replication lag:").arg(name));
+        return -1;
+    }
+
+    QSqlQuery q(db);
+    // SHOW REPLICA STATUS is available since MySQL 8.0.22 and MariaDB 10.5.1
+    if (!q.exec(QStringLiteral("SHOW REPLICA STATUS")) && !q.exec(QStringLiteral("SHOW SLAVE STATUS"))) {
+        qCWarning(FIR_CORE) << Error(q.lastError(), QStringLiteral("Failed to query the replication status of \"%1\":").arg(name));
+        return -1;
+    }
+
+    if (!q.next()) {
+        qCWarning(FIR_CORE, "Connection \"%s\" does not belong to a replica.", qUtf8Printable(name));
+        return -1;
+    }
+
+    const QSqlRecord record = q.record();
+    const QVariant seconds = record.contains(QStringLiteral("Seconds_Behind_Source")) ? q.value(QStringLiteral("Seconds_Behind_Source")) : q.value(QStringLiteral("Seconds_Behind_Master"));
+    if (seconds.isNull()) {
+        // replication is not running
+        qCWarning(FIR_CORE, "Replication on \"%s\" is not running.", qUtf8Printable(name));
+        return -1;
+    }
+
+    return seconds.toLongLong() * 1000;
+}
+
+qint64 Firfuorida::pgStatReplicationLag(const QSqlDatabase &db)
+{
+    QSqlQuery q(db);
+    // replay_lag is available since PostgreSQL 10
+    if (!q.exec(QStringLiteral("SELECT COALESCE(MAX(EXTRACT(EPOCH FROM replay_lag)), 0) * 1000 FROM pg_stat_replication")) || !q.next()) {
+        qCWarning(FIR_CORE) << Error(q.lastError(), QStringLiteral("Failed to query the replication lag from pg_stat_replication:"));
+        return -1;
+    }
+
+    return static_cast<qint64>(q.value(0).toDouble());
+}
+
+void Firfuorida::removeLagConnections()
+{
+    const QString prefix = lagConnectionPrefix();
+    const QStringList names = QSqlDatabase::connectionNames();
+    for (const QString &name : names) {
+        if (name.startsWith(prefix)) {
+            QSqlDatabase::removeDatabase(name);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_LAGTHROTTLE_P_H
+#define FIRFUORIDA_LAGTHROTTLE_P_H
+
+#include "migrator.h"
+#include <QElapsedTimer>
+#include <functional>
+
+namespace Firfuorida {
+
+class BackgroundConnection;
+
+/*!
+ * \internal
+ * \brief Pauses the execution of migration statements while the replication lag is too high.
+ *
+ * Every thread that executes statements uses its own copy, as the probe is called
+ * with the connection of that thread.
+ */
+class LagThrottle
+{
+public:
+    /*!
+     * \brief Blocks while the lag measured on \a db exceeds maxLag and returns the milliseconds waited.
+     *
+     * The probe is called at most once per pollInterval. An unknown lag blocks like a lag
+     * that is too high. Waiting stops early if \a interrupted returns \c true.
+     */
+    qint64 wait(const QSqlDatabase &db, const std::function<bool()> &interrupted = std::function<bool()>());
+
+    Migrator::LagProbe probe;
+    qint64 maxLag = 0;
+    int pollInterval = 1000;
+
+private:
+    QElapsedTimer m_lastCheck;
+};
+
+/*!
+ * \internal
+ * \brief Returns the lag of the MySQL/MariaDB \a replica in milliseconds, or \c -1 if it is unknown.
+ *
+ * Every thread opens its own connection to the replica, named after the thread and \a name.
+ */
+qint64 replicaStatusLag(const BackgroundConnection &replica, const QString &name);
+
+/*!
+ * \internal
+ * \brief Returns the highest replay lag of all PostgreSQL standbys connected to \a db in milliseconds.
+ */
+qint64 pgStatReplicationLag(const QSqlDatabase &db);
+
+/*!
+ * \internal
+ * \brief Removes the replica connections opened by replicaStatusLag() in the current thread.
+ */
+void removeLagConnections();
+
+}
+
+#endif // FIRFUORIDA_LAGTHROTTLE_P_H
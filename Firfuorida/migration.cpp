@@ -4,18 +4,243 @@
  */
 
 #include "migration_p.h"
+#include "migrator_p.h"
 #include "table_p.h"
 #include "table.h"
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QCryptographicHash>
+#include <QThread>
 #include "logging.h"
+#include <algorithm>
+#include <random>
 
 using namespace Firfuorida;
 
+namespace {
+
+void addToChecksum(QCryptographicHash &hash, const TablePrivate *table)
+{
+    if (table->operation == TablePrivate::ExecuteUpFunction) {
+        hash.addData(QByteArrayLiteral("executeUp()"));
+    } else {
+        hash.addData(table->queryString().toUtf8());
+    }
+    hash.addData(QByteArrayLiteral(";"));
+}
+
+/*!
+ * \internal
+ * \brief Returns the checksum over the statements covered by \a previous and the one of \a table.
+ *
+ * Chaining the checksums yields one for every number of applied statements, so that a resumed
+ * migration only has to match the statements applied before.
+ */
+QByteArray chainChecksum(const QByteArray &previous, const TablePrivate *table)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(previous);
+    addToChecksum(hash, table);
+    return hash.result().toHex();
+}
+
+/*!
+ * \internal
+ * \brief Sets the lock timeout of a connection for its lifetime and restores the previous one afterwards.
+ */
+class LockTimeoutScope
+{
+public:
+    LockTimeoutScope(const QSqlDatabase &db, const Dialect *dialect, int msecs) :
+        m_db(db), m_dialect(dialect), m_msecs(msecs)
+    {
+        apply();
+    }
+
+    ~LockTimeoutScope()
+    {
+        if (!m_active) {
+            return;
+        }
+        QSqlQuery q(m_db);
+        if (!q.exec(m_dialect->restoreLockTimeoutQuery(m_previous))) {
+            qCWarning(FIR_CORE) << "Failed to restore lock timeout:" << q.lastError();
+        }
+    }
+
+    /*!
+     * \brief Sets the lock timeout, call it again after the connection has been reopened.
+     */
+    void apply()
+    {
+        if (m_msecs <= 0) {
+            return;
+        }
+        const QString qs = m_dialect->lockTimeoutQuery(m_msecs);
+        if (qs.isEmpty()) {
+            qCWarning(FIR_CORE, "Lock timeouts are not supported by this database system.");
+            return;
+        }
+        QSqlQuery q(m_db);
+        // a reopened connection starts with the default of the server again
+        if (!q.exec(m_dialect->currentLockTimeoutQuery()) || !q.next()) {
+            qCWarning(FIR_CORE) << "Failed to query the current lock timeout, keeping it:" << q.lastError();
+            return;
+        }
+        m_previous = q.value(0).toString();
+        if (q.exec(qs)) {
+            m_active = true;
+        } else {
+            qCWarning(FIR_CORE) << "Failed to set lock timeout:" << q.lastError();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(LockTimeoutScope)
+    QSqlDatabase m_db;
+    const Dialect *m_dialect;
+    QString m_previous;
+    const int m_msecs;
+    bool m_active = false;
+};
+
+int jitteredDelay(int baseDelay, int attempt)
+{
+    static thread_local std::minstd_rand engine(std::random_device{}());
+    const int max = baseDelay << std::min(attempt, 10);
+    std::uniform_int_distribution<int> distribution(max / 2, max);
+    return distribution(engine);
+}
+
+/*!
+ * \internal
+ * \brief Updates \a inTransaction after \a statement has been executed successfully.
+ *
+ * Only explicit transaction statements are recognized. Statements that implicitly commit on
+ * MySQL/MariaDB keep the transaction open as far as retries are concerned.
+ */
+void trackTransaction(const QString &statement, bool &inTransaction)
+{
+    const QString s = statement.trimmed();
+    const auto startsWith = [&s](QLatin1String keyword) {
+        return s.startsWith(keyword, Qt::CaseInsensitive) && (s.size() == keyword.size() || !s.at(keyword.size()).isLetterOrNumber());
+    };
+    if (startsWith(QLatin1String("BEGIN")) || startsWith(QLatin1String("START TRANSACTION"))) {
+        inTransaction = true;
+    } else if (startsWith(QLatin1String("COMMIT")) || startsWith(QLatin1String("END")) || (startsWith(QLatin1String("ROLLBACK")) && !s.contains(QLatin1String(" TO "), Qt::CaseInsensitive))) {
+        inTransaction = false;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Executes \a statement and retries it with jittered backoff as long as it fails with a transient error.
+ *
+ * Statements inside an explicit transaction are not retried. PostgreSQL aborts the transaction
+ * on every error, MySQL/MariaDB roll it back on deadlocks and a lost connection loses it. The
+ * progress stored inside the transaction is lost as well, so resuming the migration starts
+ * over at the beginning of the transaction.
+ */
+bool execute(QSqlDatabase &db, QSqlQuery &query, const QString &statement, const Dialect *dialect, const ExecutionOptions &options, LockTimeoutScope &lockScope, Cancellation &cancellation, bool &inTransaction, const char *migration)
+{
+    for (int attempt = 0; ; ++attempt) {
+        if (query.exec(statement)) {
+            trackTransaction(statement, inTransaction);
+            return true;
+        }
+        const Error::Category category = dialect->classifyError(query.lastError());
+        if (attempt >= options.retries || cancellation.isCancelled() || !Error(query.lastError(), QString(), category).isTransient()) {
+            return false;
+        }
+        if (inTransaction) {
+            qCWarning(FIR_CORE, "Transient error in migration %s inside a transaction, not retrying: %s", migration, qUtf8Printable(query.lastError().text()));
+            return false;
+        }
+        const int delay = jitteredDelay(options.retryDelay, attempt);
+        qCWarning(FIR_CORE, "Transient error in migration %s, retrying in %i ms (%i of %i): %s", migration, delay, attempt + 1, options.retries, qUtf8Printable(query.lastError().text()));
+        QThread::msleep(static_cast<unsigned long>(delay));
+        if (cancellation.isCancelled()) {
+            return false;
+        }
+        if (category == Error::ConnectionLost) {
+            db.close();
+            if (!db.open()) {
+                qCWarning(FIR_CORE) << "Failed to reopen database connection:" << db.lastError();
+                continue;
+            }
+            query = QSqlQuery(db);
+            lockScope.apply();
+            cancellation.reattach(db, dialect);
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Returns the error for \a what being cancelled before or, if \a sqlError is set, during \a statement of \a statements.
+ */
+Error cancelledError(const Cancellation &cancellation, const QSqlError &sqlError, const QString &what, int statement, int statements)
+{
+    const QString reason = cancellation.reason() == Cancellation::TimedOut ? QStringLiteral("timed out") : QStringLiteral("has been cancelled");
+    const QString position = sqlError.type() == QSqlError::NoError ? QStringLiteral("before") : QStringLiteral("during");
+    return Error(sqlError, QStringLiteral("%1 %2 %3 statement %4 of %5.").arg(what, reason, position, QString::number(statement), QString::number(statements)), Error::Cancelled);
+}
+
+}
+
+QList<Table *> MigrationPrivate::declare()
+{
+    Q_Q(Migration);
+    q->up();
+    return q->findChildren<Table *>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+QByteArray MigrationPrivate::renderChecksum()
+{
+    const QList<Table *> tables = declare();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (Table *t : tables) {
+        addToChecksum(hash, t->d_func());
+    }
+    qDeleteAll(tables);
+    return hash.result().toHex();
+}
+
+bool MigrationPrivate::renderStatements(QStringList &statements)
+{
+    lastError = Error();
+    checksum.clear();
+
+    Q_Q(Migration);
+
+    const QList<Table *> tables = declare();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (Table *t : tables) {
+        addToChecksum(hash, t->d_func());
+        if (t->d_func()->operation == TablePrivate::ExecuteUpFunction) {
+            lastError = Error(Error::InternalError, QStringLiteral("Migration \"%1\" can not use a custom up function, it is executed on a separate connection.").arg(QString::fromLatin1(q->metaObject()->className())));
+            qCCritical(FIR_CORE) << lastError;
+            qDeleteAll(tables);
+            return false;
+        }
+        const QString statement = t->d_func()->queryString();
+        if (!statement.isEmpty()) {
+            statements << statement;
+        }
+    }
+    qDeleteAll(tables);
+
+    checksum = hash.result().toHex();
+
+    return true;
+}
+
 bool MigrationPrivate::migrate(const QString &connectionName)
 {
     lastError = Error();
+    checksum.clear();
+    lagWait = 0;
 
     Q_Q(Migration);
 
@@ -26,27 +251,95 @@ bool MigrationPrivate::migrate(const QString &connectionName)
         return false;
     }
 
+    MigratorPrivate *migrator = MigratorPrivate::get(qobject_cast<Migrator*>(q->parent()));
+    const ExecutionOptions &options = migrator->executionOptions;
+    Cancellation &cancellation = migrator->cancellation;
+
     q->up();
 
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
     const QList<Table *> tables = q->findChildren<Table *>(QString(), Qt::FindDirectChildrenOnly);
     if (tables.empty()) {
         qCWarning(FIR_CORE, "Nothing to do for migration \"%s\".", qUtf8Printable(QString::fromLatin1(q->metaObject()->className())));
+        checksum = hash.result().toHex();
         return true;
     }
 
-    QSqlQuery query(db);
+    // the checksums are needed to verify a resumed migration before anything is executed,
+    // the one at index i covers the first i statements
+    std::vector<QByteArray> progressChecksums;
+    progressChecksums.reserve(static_cast<std::size_t>(tables.size()) + 1);
+    progressChecksums.emplace_back();
     for (Table *t : tables) {
+        addToChecksum(hash, t->d_func());
+        progressChecksums.push_back(chainChecksum(progressChecksums.back(), t->d_func()));
+    }
+    checksum = hash.result().toHex();
+
+    const QString what = QStringLiteral("Migration \"%1\"").arg(QString::fromLatin1(q->metaObject()->className()));
+    if (resumeFrom > 0) {
+        // statements after the failed one may have been changed, but not the applied ones
+        if (resumeFrom > tables.size() || (!resumeChecksum.isEmpty() && resumeChecksum != progressChecksums.at(static_cast<std::size_t>(resumeFrom)))) {
+            lastError = Error(Error::InternalError, QStringLiteral("%1 has been changed within the first %2 statements that have already been applied, it can not be resumed.").arg(what, QString::number(resumeFrom)));
+            qCCritical(FIR_CORE) << lastError;
+            qDeleteAll(tables);
+            return false;
+        }
+        qCInfo(FIR_CORE, "Resuming migration %s at statement %i of %i", q->metaObject()->className(), resumeFrom + 1, static_cast<int>(tables.size()));
+    }
+
+    LockTimeoutScope lockScope(db, migrator->context.dialect, lockTimeout >= 0 ? lockTimeout : options.timeout);
+    const CancelTimer cancelTimer(cancellation, timeout >= 0 ? timeout : options.migrationTimeout);
+    QSqlQuery query(db);
+    bool inTransaction = false;
+    for (int i = resumeFrom; i < tables.size(); ++i) {
+        Table *t = tables.at(i);
+        if (cancellation.isCancelled()) {
+            lastError = cancelledError(cancellation, QSqlError(), what, i + 1, static_cast<int>(tables.size()));
+            qCCritical(FIR_CORE) << lastError;
+            qDeleteAll(tables);
+            return false;
+        }
         if (t->d_func()->operation == TablePrivate::ExecuteUpFunction) {
             if (!q->executeUp()) {
                 lastError = Error(Error::InternalError, QStringLiteral("Failed to execute custom up function for migration \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())));
                 qCCritical(FIR_CORE) << lastError;
+                qDeleteAll(tables);
                 return false;
             }
         } else {
-            if (!query.exec(t->d_func()->queryString())) {
-                lastError = Error(query.lastError(), QStringLiteral("Failed to execute SQL query for migration \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())));
+            const QString statement = t->d_func()->queryString();
+            if (statement.isEmpty()) {
+                continue;
+            }
+            if (throttle && i > resumeFrom) {
+                lagWait += throttle->wait(db, [&cancellation]() { return cancellation.isCancelled(); });
+                if (cancellation.isCancelled()) {
+                    lastError = cancelledError(cancellation, QSqlError(), what, i + 1, static_cast<int>(tables.size()));
+                    qCCritical(FIR_CORE) << lastError;
+                    qDeleteAll(tables);
+                    return false;
+                }
+            }
+            if (!execute(db, query, statement, migrator->context.dialect, options, lockScope, cancellation, inTransaction, q->metaObject()->className())) {
+                if (cancellation.isCancelled()) {
+                    lastError = cancelledError(cancellation, query.lastError(), what, i + 1, static_cast<int>(tables.size()));
+                } else {
+                    lastError = Error(query.lastError(), QStringLiteral("Failed to execute SQL query for migration \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())), migrator->context.dialect->classifyError(query.lastError()));
+                }
                 qCCritical(FIR_CORE) << lastError;
                 qCCritical(FIR_CORE, "Failed query: %s", qUtf8Printable(query.lastQuery()));
+                qDeleteAll(tables);
+                return false;
+            }
+        }
+        if (checkpoint) {
+            const QSqlError error = checkpoint(i + 1, progressChecksums.at(static_cast<std::size_t>(i) + 1));
+            if (error.type() != QSqlError::NoError) {
+                lastError = Error(error, QStringLiteral("Failed to store the progress of migration \"%1\" after statement %2 of %3:").arg(QString::fromLatin1(q->metaObject()->className()), QString::number(i + 1), QString::number(tables.size())));
+                qCCritical(FIR_CORE) << lastError;
+                qDeleteAll(tables);
                 return false;
             }
         }
@@ -70,6 +363,10 @@ bool MigrationPrivate::rollback(const QString &connectionName)
         return false;
     }
 
+    MigratorPrivate *migrator = MigratorPrivate::get(qobject_cast<Migrator*>(q->parent()));
+    const ExecutionOptions &options = migrator->executionOptions;
+    Cancellation &cancellation = migrator->cancellation;
+
     q->down();
 
     const QList<Table *> tables = q->findChildren<Table *>(QString(), Qt::FindDirectChildrenOnly);
@@ -78,19 +375,40 @@ bool MigrationPrivate::rollback(const QString &connectionName)
         return true;
     }
 
+    const QString what = QStringLiteral("Rollback of migration \"%1\"").arg(QString::fromLatin1(q->metaObject()->className()));
+    LockTimeoutScope lockScope(db, migrator->context.dialect, lockTimeout >= 0 ? lockTimeout : options.timeout);
+    const CancelTimer cancelTimer(cancellation, timeout >= 0 ? timeout : options.migrationTimeout);
     QSqlQuery query(db);
-    for (Table *t : tables) {
+    bool inTransaction = false;
+    for (int i = 0; i < tables.size(); ++i) {
+        Table *t = tables.at(i);
+        if (cancellation.isCancelled()) {
+            lastError = cancelledError(cancellation, QSqlError(), what, i + 1, static_cast<int>(tables.size()));
+            qCCritical(FIR_CORE) << lastError;
+            qDeleteAll(tables);
+            return false;
+        }
         if (t->d_func()->operation == TablePrivate::ExecuteDownFunction) {
             if (!q->executeDown()) {
                 lastError = Error(Error::InternalError, QStringLiteral("Failed to execute custom down function for migration \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())));
                 qCCritical(FIR_CORE) << lastError;
+                qDeleteAll(tables);
                 return false;
             }
         } else {
-            if (!query.exec(t->d_func()->queryString())) {
-                lastError = Error(query.lastError(), QStringLiteral("Failed to execute SQL query for rolling back \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())));
+            const QString statement = t->d_func()->queryString();
+            if (statement.isEmpty()) {
+                continue;
+            }
+            if (!execute(db, query, statement, migrator->context.dialect, options, lockScope, cancellation, inTransaction, q->metaObject()->className())) {
+                if (cancellation.isCancelled()) {
+                    lastError = cancelledError(cancellation, query.lastError(), what, i + 1, static_cast<int>(tables.size()));
+                } else {
+                    lastError = Error(query.lastError(), QStringLiteral("Failed to execute SQL query for rolling back \"%1\".").arg(QString::fromLatin1(q->metaObject()->className())), migrator->context.dialect->classifyError(query.lastError()));
+                }
                 qCCritical(FIR_CORE) << lastError;
                 qCCritical(FIR_CORE, "Failed query: %s", qUtf8Printable(query.lastQuery()));
+                qDeleteAll(tables);
                 return false;
             }
         }
@@ -194,6 +512,31 @@ bool Migration::executeDown()
     return false;
 }
 
+Migrator::Phase Migration::phase() const
+{
+    Q_D(const Migration);
+    return d->phase;
+}
+
+void Migration::setLockTimeout(int msecs)
+{
+    Q_D(Migration);
+    d->lockTimeout = std::max(0, msecs);
+}
+
+void Migration::setTimeout(int msecs)
+{
+    Q_D(Migration);
+    d->timeout = std::max(0, msecs);
+}
+
+void Migration::setPhase(Migrator::Phase phase)
+{
+    Q_ASSERT_X(phase == Migrator::PreDeploy || phase == Migrator::PostDeploy || phase == Migrator::Background, "set phase", "a migration can only belong to a single phase");
+    Q_D(Migration);
+    d->phase = phase;
+}
+
 Migrator::DatabaseType Migration::dbType() const
 {
     return qobject_cast<Migrator*>(parent())->dbType();
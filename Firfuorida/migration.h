@@ -61,7 +61,47 @@ public:
      */
     ~Migration() override;
 
+    /*!
+     * \brief Returns the deployment phase of this migration.
+     *
+     * The default is Migrator::PreDeploy.
+     */
+    Migrator::Phase phase() const;
+
 protected:
+    /*!
+     * \brief Sets the deployment \a phase of this migration.
+     *
+     * Call this in the constructor of migrations that contract the schema, like
+     * dropping columns or tables, so that they are only applied by
+     * Migrator::migrate(Migrator::PostDeploy) after the application has been updated.
+     *
+     * \code{.cpp}
+     * M20190121T174100_DropOldColumn::M20190121T174100_DropOldColumn(Firfuorida::Migrator *parent) :
+     *     Firfuorida::Migration(parent)
+     * {
+     *     setPhase(Firfuorida::Migrator::PostDeploy);
+     * }
+     * \endcode
+     */
+    void setPhase(Migrator::Phase phase);
+
+    /*!
+     * \brief Limits the time statements of this migration wait for locks to \a msecs milliseconds.
+     *
+     * Overrides Migrator::setLockTimeout() for this migration. A value of \c 0 keeps the
+     * timeout of the database session. Call this in the constructor of the migration.
+     */
+    void setLockTimeout(int msecs);
+
+    /*!
+     * \brief Cancels this migration if it has not finished after \a msecs milliseconds.
+     *
+     * Overrides Migrator::setMigrationTimeout() for this migration. A value of \c 0 disables
+     * the timeout. Call this in the constructor of the migration.
+     */
+    void setTimeout(int msecs);
+
     /*!
      * \brief Reimplement this function to perform database operations when performing migrations.
      *
@@ -194,6 +234,55 @@ protected:
     Error lastError() const;
 };
 
+/*!
+ * \brief Adds the migration described by \a metaObject to the global migration registry.
+ *
+ * Only stores the \a factory and the \a checksum of the migration source file, the migration is
+ * not constructed. Always returns \c true so that it can be used to initialize a static
+ * variable. Use FIRFUORIDA_REGISTER_MIGRATION() instead of calling this directly.
+ *
+ * \sa Migrator::addRegisteredMigrations()
+ */
+FIRFUORIDA_EXPORT bool registerMigration(const QMetaObject *metaObject, const Migrator::MigrationFactory &factory, const char *checksum = nullptr);
+
 }
 
+/*!
+ * \brief Registers the migration class \a Class in the global migration registry.
+ *
+ * Put this into the implementation file of the migration. All registered migrations
+ * can be added to a Migrator by Migrator::addRegisteredMigrations() without having
+ * to list them in the application code.
+ *
+ * \code{.cpp}
+ * #include "m20190121t174100_example.h"
+ *
+ * FIRFUORIDA_REGISTER_MIGRATION(M20190121T174100_Example)
+ * \endcode
+ *
+ * If the implementation file is passed to the firfuorida_migration_checksums() CMake function,
+ * the MD5 hash of the file is registered together with the migration. It is stored next to
+ * the checksum of the SQL when the migration is applied and lets Migrator::verifyChecksums()
+ * skip calling up() as long as the file is unchanged.
+ *
+ * \a Class can be a qualified name like \c ns::M20190121T174100_Example. The registration
+ * variable is named after the line of the macro, so use it only once per line.
+ *
+ * \note If the migrations are part of a static library, the linker might drop object files
+ * that are not referenced otherwise, together with their registration.
+ */
+#define FIRFUORIDA_REGISTER_MIGRATION(Class) \
+    namespace { \
+    const bool FIRFUORIDA_REGISTERED_VAR(__LINE__) = Firfuorida::registerMigration(&Class::staticMetaObject, [](Firfuorida::Migrator *parent) -> Firfuorida::Migration* { return new Class(parent); }, FIRFUORIDA_MIGRATION_CHECKSUM); \
+    }
+
+// two levels are needed so that __LINE__ is expanded before it gets concatenated
+#define FIRFUORIDA_REGISTERED_VAR(line) FIRFUORIDA_REGISTERED_VAR_CONCAT(line)
+#define FIRFUORIDA_REGISTERED_VAR_CONCAT(line) firfuoridaRegisteredMigration##line
+
+#ifndef FIRFUORIDA_MIGRATION_CHECKSUM
+// set by the firfuorida_migration_checksums() CMake function
+#define FIRFUORIDA_MIGRATION_CHECKSUM nullptr
+#endif
+
 #endif // FIRFUORIDA_MIGRATION_H
@@ -7,16 +7,63 @@
 #define FIRFUORIDA_MIGRATION_P_H
 
 #include "migration.h"
+#include "lagthrottle_p.h"
+#include <QSqlError>
+#include <functional>
 
 namespace Firfuorida {
 
 class MigrationPrivate {
 public:
+    static MigrationPrivate *get(Migration *q) { return q->d_func(); }
+
+    /*!
+     * \brief Calls up() and returns the tables it declared, the caller has to delete them.
+     */
+    QList<Table *> declare();
+
+    /*!
+     * \brief Returns the checksum over the SQL rendered by up() without executing it.
+     */
+    QByteArray renderChecksum();
+
+    /*!
+     * \brief Renders the SQL statements of up() into \a statements without executing them and sets the checksum.
+     *
+     * Returns \c false if up() uses executeUpFunction(), as the statements are meant to
+     * be executed outside of this migration.
+     */
+    bool renderStatements(QStringList &statements);
+
+    /*!
+     * \brief Executes the statements of up(), skipping the first resumeFrom ones.
+     *
+     * The checkpoint is called after every statement with the number of statements
+     * applied so far and the checksum over these statements.
+     */
     bool migrate(const QString &connectionName);
     bool rollback(const QString &connectionName);
 
     Migration *q_ptr = nullptr;
     Error lastError;
+    // hex encoded MD5 over the statements of up(), set by migrate() before they are executed
+    QByteArray checksum;
+    // hex encoded MD5 over the source file of a registered migration, empty if not known
+    QByteArray sourceChecksum;
+    Migrator::Phase phase = Migrator::PreDeploy;
+    // set by the Migrator for the duration of migrate()
+    LagThrottle *throttle = nullptr;
+    // milliseconds the last migrate() has been paused by the throttle
+    qint64 lagWait = 0;
+    // set by the Migrator for the duration of migrate(), stores the progress and returns its error
+    std::function<QSqlError(int progress, const QByteArray &checksum)> checkpoint;
+    // statements applied by an earlier run that failed and the checksum over these statements
+    int resumeFrom = 0;
+    QByteArray resumeChecksum;
+    // set by Migration::setLockTimeout(), overrides the timeout of the run if not negative
+    int lockTimeout = -1;
+    // set by Migration::setTimeout(), overrides the migration timeout of the run if not negative
+    int timeout = -1;
     Q_DECLARE_PUBLIC(Migration)
 };
 
@@ -5,34 +5,137 @@
 
 #include "migrator_p.h"
 #include "migration_p.h"
+#include "table_p.h"
+#include "schema_p.h"
+#include "schemadiff_p.h"
+#include "backgroundworker_p.h"
+#include "lagthrottle_p.h"
+#include <QMetaObject>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QHash>
 #include <limits>
 #include "logging.h"
 #include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
 
 Q_LOGGING_CATEGORY(FIR_CORE, "libfirfuorida.core")
 
 using namespace Firfuorida;
 
+namespace {
+
+struct RegisteredMigration {
+    const QMetaObject *metaObject;
+    Migrator::MigrationFactory factory;
+    QByteArray checksum;
+};
+
+struct BookkeepingColumn {
+    const char *name;
+    const char *definition;
+};
+
+// columns added after the first release, they are added to existing migration tables on demand
+constexpr BookkeepingColumn bookkeepingColumns[] = {
+    {"checksum",        "VARCHAR(32)"},
+    {"execution_time",  "INTEGER"},
+    {"batch",           "INTEGER"},
+    {"phase",           "INTEGER"},
+    {"progress",        "INTEGER"},
+    {"lag_wait",        "INTEGER"},
+    {"source_checksum", "VARCHAR(32)"}
+};
+
+// statements of a migration applied by an earlier run that failed
+struct Checkpoint {
+    int progress;
+    QByteArray checksum;
+};
+
+/*!
+ * \internal
+ * \brief Returns the condition for rows of the migrations table that have been applied completely.
+ *
+ * Rows with a progress are checkpoints of partially applied migrations or background
+ * migrations that have not finished yet, so they can not be rolled back.
+ */
+QString appliedCondition()
+{
+    return QStringLiteral("progress IS NULL");
+}
+
+/*!
+ * \internal
+ * \brief Returns the value to bind for the source \a checksum, \c NULL if it is not known.
+ */
+QVariant sourceChecksumValue(const QByteArray &checksum)
+{
+    return checksum.isEmpty() ? QVariant() : QVariant(QString::fromLatin1(checksum));
+}
+
+std::vector<RegisteredMigration> &migrationRegistry()
+{
+    static std::vector<RegisteredMigration> registry;
+    return registry;
+}
+
+}
+
+bool Firfuorida::registerMigration(const QMetaObject *metaObject, const Migrator::MigrationFactory &factory, const char *checksum)
+{
+    Q_ASSERT_X(metaObject, "register migration", "invalid meta object");
+    Q_ASSERT_X(factory, "register migration", "invalid factory");
+    migrationRegistry().push_back({metaObject, factory, QByteArray(checksum)});
+    return true;
+}
+
+QString DbContext::typeToStr() const
+{
+    switch(type) {
+    case Migrator::DB2:
+        return QStringLiteral("IBM DB2");
+    case Migrator::InterBase:
+        return QStringLiteral("Borland InterBase");
+    case Migrator::MySQL:
+        return QStringLiteral("MySQL");
+    case Migrator::MariaDB:
+        return QStringLiteral("MariaDB");
+    case Migrator::ODBC:
+        return QStringLiteral("Open Database Connectivity (ODBC)");
+    case Migrator::OCI:
+        return QStringLiteral("Oracle Call Interface (OCI)");
+    case Migrator::PSQL:
+        return QStringLiteral("PostgreSQL");
+    case Migrator::SQLite:
+        return QStringLiteral("SQLite");
+    default:
+        return QStringLiteral("Invalid");
+    }
+}
+
 void MigratorPrivate::setDbType()
 {
     if (db.driverName() == QLatin1String("QDB2")) {
-        dbType = Migrator::DB2;
+        context.type = Migrator::DB2;
     } else if (db.driverName() == QLatin1String("QIBASE")) {
-        dbType = Migrator::InterBase;
+        context.type = Migrator::InterBase;
     } else if (db.driverName() == QLatin1String("QMYSQL")) {
-        dbType = Migrator::MySQL;
+        context.type = Migrator::MySQL;
     } else if (db.driverName() == QLatin1String("QMARIADB")) {
-        dbType = Migrator::MariaDB;
+        context.type = Migrator::MariaDB;
     } else if (db.driverName() == QLatin1String("QODBC")) {
-        dbType = Migrator::ODBC;
+        context.type = Migrator::ODBC;
     } else if (db.driverName() == QLatin1String("QOCI")) {
-        dbType = Migrator::OCI;
+        context.type = Migrator::OCI;
     } else if (db.driverName() == QLatin1String("QPSQL")) {
-        dbType = Migrator::PSQL;
+        context.type = Migrator::PSQL;
     } else if (db.driverName() == QLatin1String("QSQLITE")) {
-        dbType = Migrator::SQLite;
+        context.type = Migrator::SQLite;
     } else {
         qCWarning(FIR_CORE, "Invalid/not supported database driver \"%s\" set.", qUtf8Printable(db.driverName()));
     }
@@ -41,16 +144,16 @@ void MigratorPrivate::setDbType()
 void MigratorPrivate::setDbVersion()
 {
     QSqlQuery q(db);
-    if (dbType == Migrator::MySQL || dbType == Migrator::MariaDB) {
+    if (context.type == Migrator::MySQL || context.type == Migrator::MariaDB) {
         if (q.exec(QStringLiteral("SHOW VARIABLES WHERE Variable_name = 'version'"))) {
             if (q.next()) {
                 const QString version = q.value(1).toString();
                 int suffixIndex = -1;
-                dbVersion = QVersionNumber::fromString(version, &suffixIndex);
-                if (!dbVersion.isNull()) {
+                context.version = QVersionNumber::fromString(version, &suffixIndex);
+                if (!context.version.isNull()) {
                     if (suffixIndex > -1) {
                         if (version.mid(suffixIndex).contains(QLatin1String("MariaDB"), Qt::CaseInsensitive)) {
-                            dbType = Migrator::MariaDB;
+                            context.type = Migrator::MariaDB;
                         }
                     }
                 } else {
@@ -62,26 +165,26 @@ void MigratorPrivate::setDbVersion()
         } else {
             qCCritical(FIR_CORE, "Failed to execute query to determine MySQL/MariaDB database version: %s", qUtf8Printable(q.lastError().text()));
         }
-    } else if (dbType == Migrator::SQLite) {
+    } else if (context.type == Migrator::SQLite) {
         if (q.exec(QStringLiteral("SELECT sqlite_version()"))) {
             if (q.next()) {
                 const QString version = q.value(0).toString();
-                dbVersion = QVersionNumber::fromString(version);
+                context.version = QVersionNumber::fromString(version);
             } else {
                 qCCritical(FIR_CORE, "%s", "Can not find database version information.");
             }
         } else {
             qCCritical(FIR_CORE, "Failed to execute query to determine SQLite database version: %s", qUtf8Printable(q.lastError().text()));
         }
-    } else if (dbType == Migrator::PSQL) {
+    } else if (context.type == Migrator::PSQL) {
         if (q.exec(QStringLiteral("SELECT version()"))) {
             if (q.next()) {
                 const auto version = q.value(0).toString();
                 QRegularExpression regex{QStringLiteral(R"-(^PostgreSQL ([1-9][0-9]*[0-9\.]*))-")};
                 const auto match = regex.match(version);
                 if (match.hasMatch()) {
-                    dbVersion = QVersionNumber::fromString(match.captured(1));
-                    if (dbVersion.isNull()) {
+                    context.version = QVersionNumber::fromString(match.captured(1));
+                    if (context.version.isNull()) {
                         qCWarning(FIR_CORE) << "Can not find valid database version information in" << version;
                     }
                 } else {
@@ -96,318 +199,464 @@ void MigratorPrivate::setDbVersion()
     }
 }
 
-Migrator::Migrator(QObject *parent) :
-    QObject(parent), dptr(new MigratorPrivate)
+void MigratorPrivate::setDbFeatures()
 {
-    Q_D(Migrator);
-    d->connectionName = QLatin1String(QSqlDatabase::defaultConnection);
-    d->migrationsTable = QStringLiteral("migrations");
+    context.dialect = Dialect::forType(context.type);
+    context.features = context.dialect->features(context.version);
 }
 
-Migrator::Migrator(const QString &connectionName, const QString &migrationsTable, QObject *parent) : QObject(parent), dptr(new MigratorPrivate)
+Migration *MigrationEntry::instance(Migrator *migrator, std::unique_ptr<Migration> &owned) const
 {
-    Q_D(Migrator);
-    d->connectionName = connectionName;
-    d->migrationsTable = migrationsTable;
+    if (migration) {
+        return migration;
+    }
+    owned.reset(factory(migrator));
+    MigrationPrivate::get(owned.get())->sourceChecksum = sourceChecksum;
+    return owned.get();
 }
 
-Migrator::~Migrator() = default;
-
-bool Migrator::initDatabase()
+std::vector<MigrationEntry> MigratorPrivate::migrations(const Migrator *q) const
 {
-    Q_D(Migrator);
+    const QList<Migration *> children = q->findChildren<Migration *>(QString(), Qt::FindDirectChildrenOnly);
 
-    if (!d->db.isOpen()) {
-        d->db = QSqlDatabase::database(d->connectionName);
-        if (!d->db.isOpen()) {
-            d->lastError = Error(d->db.lastError(), QStringLiteral("Can not open database connection \"%1\":").arg(d->connectionName));
-            qCCritical(FIR_CORE) << d->lastError;
-            return false;
-        }
+    std::vector<MigrationEntry> entries;
+    entries.reserve(static_cast<std::size_t>(children.size()) + factories.size());
+    for (Migration *m : children) {
+        MigrationEntry e;
+        e.name = QString::fromLatin1(m->metaObject()->className());
+        e.migration = m;
+        entries.push_back(std::move(e));
     }
+    entries.insert(entries.end(), factories.cbegin(), factories.cend());
 
-    d->setDbType();
-    d->setDbVersion();
+    std::stable_sort(entries.begin(), entries.end(), [](const MigrationEntry &a, const MigrationEntry &b) {
+        return a.name < b.name;
+    });
 
-    switch (d->dbType) {
-    case DB2:
-    case InterBase:
-        break;
-    case MySQL:
-    {
-        d->dbFeatures |= GeometryTypes;
-        if (d->dbVersion >= QVersionNumber(5,7,8)) {
-            d->dbFeatures |= JSONTypes;
-        }
-        if (d->dbVersion >= QVersionNumber(8,0,13)) {
-            d->dbFeatures |= DefValOnText;
-            d->dbFeatures |= DefValOnBlob;
-            d->dbFeatures |= DefValOnGeometry;
-        }
-        d->dbFeatures |= ForeignKeys;
-        d->dbFeatures |= CommentsOnColumns;
-        d->dbFeatures |= CommentsOnTables;
-        d->dbFeatures |= SetType;
-        d->dbFeatures |= EnumType;
-        d->dbFeatures |= UnsignedInteger;
-        d->dbFeatures |= CharsetOnColumn;
-        d->dbFeatures |= YearType;
-    }
-        break;
-    case MariaDB:
-    {
-        if (d->dbVersion >= QVersionNumber(10,2,1)) {
-            d->dbFeatures |= DefValOnText;
-            d->dbFeatures |= DefValOnBlob;
-        }
-        if (d->dbVersion >= QVersionNumber(10,2,7)) {
-            d->dbFeatures |= JSONTypes;
-        }
-        d->dbFeatures |= ForeignKeys;
-        d->dbFeatures |= CommentsOnColumns;
-        d->dbFeatures |= CommentsOnTables;
-        d->dbFeatures |= SetType;
-        d->dbFeatures |= EnumType;
-        d->dbFeatures |= UnsignedInteger;
-        d->dbFeatures |= CharsetOnColumn;
-        d->dbFeatures |= YearType;
-    }
-        break;
-    case ODBC:
-    case OCI:
-        break;
-    case PSQL:
-    {
-        d->dbFeatures |= DefValOnText;
-        d->dbFeatures |= DefValOnBlob;
-        d->dbFeatures |= DefValOnGeometry;
-        d->dbFeatures |= JSONTypes;
-        d->dbFeatures |= GeometryTypes;
-        d->dbFeatures |= XMLType;
-        d->dbFeatures |= NetworkAddressTypes;
-        d->dbFeatures |= MonetaryTypes;
-        d->dbFeatures |= ForeignKeys;
-        d->dbFeatures |= CommentsOnColumns;
-        d->dbFeatures |= CommentsOnTables;
-        d->dbFeatures |= SetType;
-        d->dbFeatures |= EnumType;
-    }
-        break;
-    case SQLite:
-    {
-        d->dbFeatures |= DefValOnText;
-        d->dbFeatures |= DefValOnBlob;
-        if (d->dbVersion >= QVersionNumber(3,6,19)) {
-            d->dbFeatures |= ForeignKeys;
+    return entries;
+}
+
+bool MigratorPrivate::prepareMigrationsTable()
+{
+    QSqlQuery query(db);
+    if (!query.exec(context.dialect->migrationsTableQuery(migrationsTable))) {
+        lastError = Error(query.lastError(), QStringLiteral("Can not create migrations table \"%1\":").arg(migrationsTable));
+        qCCritical(FIR_CORE) << lastError;
+        return false;
+    }
+
+    const QSqlRecord record = db.record(migrationsTable);
+    for (const BookkeepingColumn &col : bookkeepingColumns) {
+        const QString name = QLatin1String(col.name);
+        if (record.contains(name)) {
+            continue;
         }
-        if (d->dbVersion >= QVersionNumber(3,38,0)) {
-            d->dbFeatures |= JSONTypes;
+        qCInfo(FIR_CORE, "Adding column %s to migrations table \"%s\"", col.name, qUtf8Printable(migrationsTable));
+        if (!query.exec(QStringLiteral("ALTER TABLE %1 ADD COLUMN %2 %3").arg(migrationsTable, name, QLatin1String(col.definition)))) {
+            lastError = Error(query.lastError(), QStringLiteral("Can not upgrade migrations table \"%1\":").arg(migrationsTable));
+            qCCritical(FIR_CORE) << lastError;
+            return false;
         }
     }
-        break;
-    default:
-        break;
-    }
 
     return true;
 }
 
-Migrator::DatabaseType Migrator::dbType() const
+bool MigratorPrivate::applyBaseline(Migrator *q, const std::vector<MigrationEntry> &migrations, QSet<QString> &applied, int batch)
 {
-    Q_D(const Migrator);
-    return d->dbType;
-}
+    qCInfo(FIR_CORE, "Applying baseline for migrations up to %s", qUtf8Printable(baseline.name));
 
-QString Migrator::dbTypeToStr() const
-{
-    Q_D(const Migrator);
-    switch(d->dbType) {
-    case DB2:
-        return QStringLiteral("IBM DB2");
-    case InterBase:
-        return QStringLiteral("Borland InterBase");
-    case MySQL:
-        return QStringLiteral("MySQL");
-    case MariaDB:
-        return QStringLiteral("MariaDB");
-    case ODBC:
-        return QStringLiteral("Open Database Connectivity (ODBC)");
-    case OCI:
-        return QStringLiteral("Oracle Call Interface (OCI)");
-    case PSQL:
-        return QStringLiteral("PostgreSQL");
-    case SQLite:
-        return QStringLiteral("SQLite");
-    default:
-        return QStringLiteral("Invalid");
+    std::unique_ptr<Migration> owned;
+    Migration *m = baseline.instance(q, owned);
+    if (!MigrationPrivate::get(m)->migrate(connectionName)) {
+        lastError = m->lastError();
+        return false;
     }
-}
 
-QVersionNumber Migrator::dbVersion() const
-{
-    Q_D(const Migrator);
-    return d->dbVersion;
-}
+    QStringList covered;
+    for (const MigrationEntry &entry : migrations) {
+        if (entry.name <= baseline.name) {
+            covered << entry.name;
+        }
+    }
 
-Migrator::DatabaseFeatures Migrator::dbFeatures() const
-{
-    Q_D(const Migrator);
-    return d->dbFeatures;
-}
+    if (!recordApplied(covered, batch)) {
+        return false;
+    }
 
-bool Migrator::isDbFeatureAvailable(DatabaseFeatures dbFeatures) const
-{
-    Q_D(const Migrator);
-    return (d->dbFeatures & static_cast<int>(dbFeatures)) != 0;
-}
+    for (const MigrationEntry &entry : migrations) {
+        if (entry.name <= baseline.name) {
+            applied.insert(entry.name);
+        }
+    }
 
-QString Migrator::connectionName() const
-{
-    Q_D(const Migrator);
-    return d->connectionName;
+    qCInfo(FIR_CORE, "Baseline applied, recorded %i covered migrations", static_cast<int>(covered.size()));
+
+    return true;
 }
 
-QString Migrator::migrationsTable() const
+bool MigratorPrivate::recordApplied(const QStringList &names, int batch)
 {
-    Q_D(const Migrator);
-    return d->migrationsTable;
+    if (names.empty()) {
+        return true;
+    }
+
+    // keep single statements well below the bind limits of all databases,
+    // SQLite before 3.32 allows 999 bound values per statement
+    constexpr int rowsPerStatement = 250;
+
+    const bool transaction = db.transaction();
+
+    QSqlQuery query(db);
+    int preparedRows = 0;
+    for (int i = 0; i < names.size(); i += rowsPerStatement) {
+        const int rows = std::min(rowsPerStatement, static_cast<int>(names.size()) - i);
+        // only the last statement can have less rows
+        if (rows != preparedRows) {
+            QString qs = QStringLiteral("INSERT INTO %1 (migration, batch) VALUES ").arg(migrationsTable);
+            qs.reserve(qs.size() + rows * 7);
+            for (int j = 0; j < rows; ++j) {
+                qs += j > 0 ? QLatin1String(",(?, ?)") : QLatin1String("(?, ?)");
+            }
+            query.prepare(qs);
+            preparedRows = rows;
+        }
+        for (int j = i; j < i + rows; ++j) {
+            query.addBindValue(names.at(j));
+            query.addBindValue(batch);
+        }
+        if (!query.exec()) {
+            lastError = Error(query.lastError(), QStringLiteral("Failed to record migrations covered by the baseline in migration table \"%1\":").arg(migrationsTable));
+            qCCritical(FIR_CORE) << lastError;
+            if (transaction) {
+                db.rollback();
+            }
+            return false;
+        }
+    }
+
+    if (transaction && !db.commit()) {
+        lastError = Error(db.lastError(), QStringLiteral("Failed to commit migrations covered by the baseline:"));
+        qCCritical(FIR_CORE) << lastError;
+        return false;
+    }
+
+    return true;
 }
 
-bool Migrator::migrate()
+bool MigratorPrivate::migrate(Migrator *q, const QString &upTo, Migrator::Phases phases)
 {
-    Q_D(Migrator);
+    lastError = Error();
+    lagWait = 0;
 
-    d->lastError = Error();
-
-    const QList<Migration *> migrations = findChildren<Migration *>(QString(), Qt::FindDirectChildrenOnly);
+    const std::vector<MigrationEntry> migrations = this->migrations(q);
     if (migrations.empty()) {
         qCWarning(FIR_CORE, "No migrations added to this migrator.");
         return true;
     }
 
-    if (!initDatabase()) {
+    if (!upTo.isEmpty() && !findMigration(migrations, upTo)) {
         return false;
     }
 
-    qCInfo(FIR_CORE, "Start database migrations on %s database version %s", qUtf8Printable(dbTypeToStr()), qUtf8Printable(d->dbVersion.toString()));
+    if (!q->initDatabase()) {
+        return false;
+    }
 
-    QSqlQuery query(d->db);
-    if (dbType() == Migrator::SQLite) {
-        if (!query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
-                                       "migration TEXT NOT NULL UNIQUE, "
-                                       "applied NUMERIC DEFAULT CURRENT_TIMESTAMP)").arg(d->migrationsTable))) {
-            d->lastError = Error(query.lastError(), QStringLiteral("Can not create migrations table \"%s\":").arg(d->migrationsTable));
-            qCCritical(FIR_CORE) << d->lastError;
-            return false;
+    if (upTo.isEmpty()) {
+        qCInfo(FIR_CORE, "Start database migrations on %s database version %s", qUtf8Printable(q->dbTypeToStr()), qUtf8Printable(context.version.toString()));
+    } else {
+        qCInfo(FIR_CORE, "Start database migrations up to %s on %s database version %s", qUtf8Printable(upTo), qUtf8Printable(q->dbTypeToStr()), qUtf8Printable(context.version.toString()));
+    }
+
+    if (!prepareMigrationsTable()) {
+        return false;
+    }
+
+    const CancellationScope cancellationScope(cancellation, db, context.dialect);
+
+    QSqlQuery query(db);
+    QSet<QString> appliedMigrations;
+    QHash<QString, Checkpoint> checkpoints;
+    const auto addApplied = [&appliedMigrations, &checkpoints](const QSqlQuery &q) {
+        if (q.isNull(1) || q.value(2).toInt() == static_cast<int>(Migrator::Background)) {
+            appliedMigrations.insert(q.value(0).toString());
+        } else {
+            checkpoints.insert(q.value(0).toString(), Checkpoint{q.value(1).toInt(), q.value(3).toByteArray()});
         }
-    } else if (dbType() == Migrator::PSQL) {
-        if (!query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
-                                       "migration VARCHAR(255) NOT NULL,"
-                                       "applied TIMESTAMP NOT NULL DEFAULT now(),"
-                                       "UNIQUE (migration))").arg(d->migrationsTable))) {
-            d->lastError = Error(query.lastError(), QStringLiteral("Can not create migrations table \"%s\":").arg(d->migrationsTable));
-            qCCritical(FIR_CORE) << d->lastError;
+    };
+    int batch = 1;
+    bool noneApplied = true;
+    if (upTo.isEmpty()) {
+        if (query.exec(QStringLiteral("SELECT migration, progress, phase, checksum, batch FROM %1 ORDER BY migration ASC").arg(migrationsTable))) {
+            while(query.next()) {
+                addApplied(query);
+                batch = std::max(batch, query.value(4).toInt() + 1);
+            }
+            noneApplied = appliedMigrations.empty() && checkpoints.empty();
+        } else {
+            lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
+            qCCritical(FIR_CORE) << lastError;
             return false;
         }
     } else {
-        if (!query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
-                                       "migration VARCHAR(255) NOT NULL, "
-                                       "applied DATETIME DEFAULT CURRENT_TIMESTAMP, "
-                                       "UNIQUE KEY migration (migration)"
-                                       ") DEFAULT CHARSET = latin1").arg(d->migrationsTable))) {
-            d->lastError = Error(query.lastError(), QStringLiteral("Can not create migrations table \"%s\":").arg(d->migrationsTable));
-            qCCritical(FIR_CORE) << d->lastError;
+        // only the applied migrations in range are needed, the batch comes from an aggregate
+        query.prepare(QStringLiteral("SELECT migration, progress, phase, checksum FROM %1 WHERE migration <= ?").arg(migrationsTable));
+        query.addBindValue(upTo);
+        if (query.exec()) {
+            while(query.next()) {
+                addApplied(query);
+            }
+        } else {
+            lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
+            qCCritical(FIR_CORE) << lastError;
+            return false;
+        }
+        if (query.exec(QStringLiteral("SELECT COUNT(*), MAX(batch) FROM %1").arg(migrationsTable)) && query.next()) {
+            noneApplied = query.value(0).toInt() == 0;
+            batch = std::max(batch, query.value(1).toInt() + 1);
+        } else {
+            lastError = Error(query.lastError(), QStringLiteral("Failed to query the last batch of applied migrations from the database:"));
+            qCCritical(FIR_CORE) << lastError;
             return false;
         }
     }
 
-    QStringList appliedMigrations;
-    if (query.exec(QStringLiteral("SELECT migration FROM %1 ORDER BY migration ASC").arg(d->migrationsTable))) {
-        while(query.next()) {
-            appliedMigrations << query.value(0).toString();
+    // a baseline that covers more than requested can not be applied partially
+    if (noneApplied && baseline.factory && (upTo.isEmpty() || baseline.name <= upTo)) {
+        if (!applyBaseline(q, migrations, appliedMigrations, batch)) {
+            return false;
         }
-    } else {
-        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
-        qCCritical(FIR_CORE) << d->lastError;
-        return false;
     }
 
-    for (Migration *migration : migrations) {
-        const QString className = QString::fromLatin1(migration->metaObject()->className());
-        if (!appliedMigrations.contains(className)) {
-            qCInfo(FIR_CORE, "Applying migration %s", migration->metaObject()->className());
-            if (migration->d_func()->migrate(d->connectionName)) {
-                if (!query.exec(QStringLiteral("INSERT INTO %1 (migration) VALUES ('%2')").arg(d->migrationsTable, className))) {
-                    d->lastError = Error(query.lastError(), QStringLiteral("Failed to insert applied migration \"%s\" into migration table \"%s\":").arg(QString::fromLatin1(migration->metaObject()->className()), d->migrationsTable));
-                    qCCritical(FIR_CORE) << d->lastError;
+    // the first pending expanding migration that has been skipped
+    QString pendingPreDeploy;
+
+    for (const MigrationEntry &entry : migrations) {
+        if (!upTo.isEmpty() && entry.name > upTo) {
+            break;
+        }
+        if (!appliedMigrations.contains(entry.name)) {
+            std::unique_ptr<Migration> owned;
+            Migration *migration = entry.instance(q, owned);
+            const Migrator::Phase phase = migration->phase();
+            if (!phases.testFlag(phase)) {
+                if (phase == Migrator::PreDeploy && pendingPreDeploy.isEmpty()) {
+                    pendingPreDeploy = entry.name;
+                }
+                qCDebug(FIR_CORE, "Skipping migration %s of phase %i", qUtf8Printable(entry.name), static_cast<int>(phase));
+                continue;
+            }
+            if (phase != Migrator::PreDeploy && !pendingPreDeploy.isEmpty()) {
+                lastError = Error(Error::InternalError, QStringLiteral("Can not apply migration \"%1\" while the pre-deploy migration \"%2\" is pending.").arg(entry.name, pendingPreDeploy));
+                qCCritical(FIR_CORE) << lastError;
+                return false;
+            }
+            if (phase == Migrator::Background) {
+                if (!queueBackground(entry.name, migration, batch)) {
+                    return false;
+                }
+                continue;
+            }
+            qCInfo(FIR_CORE, "Applying migration %s", qUtf8Printable(entry.name));
+            MigrationPrivate *md = MigrationPrivate::get(migration);
+            const auto checkpoint = checkpoints.constFind(entry.name);
+            // the row of the migration exists as soon as its first statement has been applied
+            bool recorded = checkpoint != checkpoints.constEnd();
+            md->resumeFrom = recorded ? checkpoint.value().progress : 0;
+            md->resumeChecksum = recorded ? checkpoint.value().checksum : QByteArray();
+            // until the migration is complete, the checksum only covers the applied statements
+            md->checkpoint = [this, &entry, phase, &recorded](int progress, const QByteArray &checksum) -> QSqlError {
+                QSqlQuery q(db);
+                if (recorded) {
+                    q.prepare(QStringLiteral("UPDATE %1 SET progress = ?, checksum = ? WHERE migration = ?").arg(migrationsTable));
+                    q.addBindValue(progress);
+                    q.addBindValue(QString::fromLatin1(checksum));
+                    q.addBindValue(entry.name);
+                } else {
+                    q.prepare(QStringLiteral("INSERT INTO %1 (migration, checksum, phase, progress) VALUES (?, ?, ?, ?)").arg(migrationsTable));
+                    q.addBindValue(entry.name);
+                    q.addBindValue(QString::fromLatin1(checksum));
+                    q.addBindValue(static_cast<int>(phase));
+                    q.addBindValue(progress);
+                }
+                if (q.exec()) {
+                    recorded = true;
+                }
+                return q.lastError();
+            };
+            md->throttle = &lagThrottle;
+            QElapsedTimer timer;
+            timer.start();
+            const bool migrated = md->migrate(connectionName);
+            md->throttle = nullptr;
+            md->checkpoint = nullptr;
+            lagWait += md->lagWait;
+            if (migrated) {
+                if (recorded) {
+                    query.prepare(QStringLiteral("UPDATE %1 SET checksum = ?, source_checksum = ?, execution_time = ?, batch = ?, phase = ?, lag_wait = ?, progress = NULL WHERE migration = ?").arg(migrationsTable));
+                } else {
+                    query.prepare(QStringLiteral("INSERT INTO %1 (checksum, source_checksum, execution_time, batch, phase, lag_wait, migration) VALUES (?, ?, ?, ?, ?, ?, ?)").arg(migrationsTable));
+                }
+                query.addBindValue(QString::fromLatin1(md->checksum));
+                query.addBindValue(sourceChecksumValue(md->sourceChecksum));
+                query.addBindValue(static_cast<qlonglong>(timer.elapsed()));
+                query.addBindValue(batch);
+                query.addBindValue(static_cast<int>(phase));
+                query.addBindValue(static_cast<qlonglong>(md->lagWait));
+                query.addBindValue(entry.name);
+                if (!query.exec()) {
+                    lastError = Error(query.lastError(), QStringLiteral("Failed to insert applied migration \"%1\" into migration table \"%2\":").arg(entry.name, migrationsTable));
+                    qCCritical(FIR_CORE) << lastError;
                     return false;
                 }
             } else {
-                d->lastError = migration->lastError();
+                lastError = migration->lastError();
                 return false;
             }
         }
     }
 
+    if (phases.testFlag(Migrator::Background)) {
+        return startBackground(q, migrations);
+    }
+
     return true;
 }
 
-bool Migrator::rollback(uint steps)
+bool MigratorPrivate::queueBackground(const QString &name, Migration *migration, int batch)
 {
-    Q_D(Migrator);
+    QStringList statements;
+    if (!MigrationPrivate::get(migration)->renderStatements(statements)) {
+        lastError = migration->lastError();
+        return false;
+    }
 
-    d->lastError = Error();
+    qCInfo(FIR_CORE, "Queueing background migration %s with %i statements", qUtf8Printable(name), static_cast<int>(statements.size()));
 
-    const QList<Migration *> migrations = findChildren<Migration *>(QString(), Qt::FindDirectChildrenOnly);
-    if (migrations.empty()) {
-        qCWarning(FIR_CORE, "No migrations added to this migrator.");
+    QSqlQuery query(db);
+    query.prepare(QStringLiteral("INSERT INTO %1 (migration, checksum, source_checksum, batch, phase, progress) VALUES (?, ?, ?, ?, ?, 0)").arg(migrationsTable));
+    query.addBindValue(name);
+    query.addBindValue(QString::fromLatin1(MigrationPrivate::get(migration)->checksum));
+    query.addBindValue(sourceChecksumValue(MigrationPrivate::get(migration)->sourceChecksum));
+    query.addBindValue(batch);
+    query.addBindValue(static_cast<int>(Migrator::Background));
+    if (!query.exec()) {
+        lastError = Error(query.lastError(), QStringLiteral("Failed to insert background migration \"%1\" into migration table \"%2\":").arg(name, migrationsTable));
+        qCCritical(FIR_CORE) << lastError;
+        return false;
+    }
+
+    return true;
+}
+
+bool MigratorPrivate::startBackground(Migrator *q, const std::vector<MigrationEntry> &migrations)
+{
+    if (isBackgroundRunning()) {
+        qCDebug(FIR_CORE, "%s", "Background migrations are already running.");
         return true;
     }
+    backgroundWorkers.clear();
+    backgroundQueue.reset();
 
-    if (!initDatabase()) {
+    QSqlQuery query(db);
+    QHash<QString, int> pending;
+    if (query.exec(QStringLiteral("SELECT migration, progress FROM %1 WHERE progress IS NOT NULL AND phase = %2").arg(migrationsTable, QString::number(static_cast<int>(Migrator::Background))))) {
+        while (query.next()) {
+            pending.insert(query.value(0).toString(), query.value(1).toInt());
+        }
+    } else {
+        lastError = Error(query.lastError(), QStringLiteral("Failed to query pending background migrations from the database:"));
+        qCCritical(FIR_CORE) << lastError;
         return false;
     }
 
-    qCInfo(FIR_CORE, "Start rolling back database migrations on %s database version %s", qUtf8Printable(dbTypeToStr()), qUtf8Printable(d->dbVersion.toString()));
+    if (pending.empty()) {
+        return true;
+    }
 
-    QStringList appliedMigrations;
-    QSqlQuery query(d->db);
-    QString qs = QStringLiteral("SELECT migration FROM %1 ORDER BY migration DESC").arg(d->migrationsTable);
-    if (steps > 0) {
-        qs += QStringLiteral(" LIMIT %1").arg(steps);
-    } else {
-        qs += QStringLiteral(" LIMIT 1");
+    auto queue = std::make_shared<BackgroundQueue>();
+    backgroundQueue = queue;
+    int jobs = 0;
+    for (const MigrationEntry &entry : migrations) {
+        const auto it = pending.constFind(entry.name);
+        if (it == pending.constEnd()) {
+            continue;
+        }
+        std::unique_ptr<Migration> owned;
+        Migration *m = entry.instance(q, owned);
+        BackgroundJob job;
+        job.name = entry.name;
+        job.progress = it.value();
+        if (!MigrationPrivate::get(m)->renderStatements(job.statements)) {
+            lastError = m->lastError();
+            return false;
+        }
+        queue->push(std::move(job));
+        ++jobs;
     }
 
-    if (query.exec(qs)) {
-        while(query.next()) {
-            appliedMigrations << query.value(0).toString();
+    if (jobs < pending.size()) {
+        qCWarning(FIR_CORE, "%i pending background migrations have not been added to this migrator.", static_cast<int>(pending.size()) - jobs);
+    }
+
+    const BackgroundConnection connection(db);
+    const int workers = std::min(backgroundConcurrency, jobs);
+    for (int i = 0; i < workers; ++i) {
+        backgroundWorkers.emplace_back(new BackgroundWorker(connection, migrationsTable, backgroundThrottle, lagThrottle, queue));
+        backgroundWorkers.back()->start(QThread::LowestPriority);
+    }
+
+    qCInfo(FIR_CORE, "Started %i background workers for %i migrations", workers, jobs);
+
+    return true;
+}
+
+bool MigratorPrivate::isBackgroundRunning() const
+{
+    for (const auto &worker : backgroundWorkers) {
+        if (worker->isRunning()) {
+            return true;
         }
-    } else {
-        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
-        qCCritical(FIR_CORE) << d->lastError;
+    }
+    return false;
+}
+
+bool MigratorPrivate::checkNoBackgroundRunning()
+{
+    if (isBackgroundRunning()) {
+        lastError = Error(Error::InternalError, QStringLiteral("Can not roll back migrations while background migrations are running."));
+        qCCritical(FIR_CORE) << lastError;
         return false;
     }
+    return true;
+}
 
-    if (appliedMigrations.empty()) {
-        qCInfo(FIR_CORE, "%s", "No migrations applied.");
-        return true;
+bool MigratorPrivate::rollbackApplied(Migrator *q, const std::vector<MigrationEntry> &migrations, const QSet<QString> &applied)
+{
+    if (!checkNoBackgroundRunning()) {
+        return false;
     }
 
-    QList<Migration *>::const_reverse_iterator i;
-    for (i = migrations.crbegin(); i != migrations.crend(); ++i) {
-        Migration *m = *i;
-        const QString migrationName = QString::fromLatin1(m->metaObject()->className());
-        if (appliedMigrations.contains(migrationName)) {
-            qCInfo(FIR_CORE, "Rolling back migration %s", m->metaObject()->className());
-            if (m->d_func()->rollback(d->connectionName)) {
-                if (!query.exec(QStringLiteral("DELETE FROM %1 WHERE migration = '%2'").arg(d->migrationsTable, migrationName))) {
-                    d->lastError = Error(query.lastError(), QStringLiteral("Failed to remove applied migration \"%s\" from the migrations table \"%s\":").arg(QString::fromLatin1(m->metaObject()->className()), d->migrationsTable));
-                    qCCritical(FIR_CORE) << d->lastError;
+    const CancellationScope cancellationScope(cancellation, db, context.dialect);
+
+    QSqlQuery query(db);
+    for (auto i = migrations.crbegin(); i != migrations.crend(); ++i) {
+        const MigrationEntry &entry = *i;
+        if (applied.contains(entry.name)) {
+            qCInfo(FIR_CORE, "Rolling back migration %s", qUtf8Printable(entry.name));
+            std::unique_ptr<Migration> owned;
+            Migration *m = entry.instance(q, owned);
+            if (MigrationPrivate::get(m)->rollback(connectionName)) {
+                query.prepare(QStringLiteral("DELETE FROM %1 WHERE migration = ?").arg(migrationsTable));
+                query.addBindValue(entry.name);
+                if (!query.exec()) {
+                    lastError = Error(query.lastError(), QStringLiteral("Failed to remove applied migration \"%1\" from the migrations table \"%2\":").arg(entry.name, migrationsTable));
+                    qCCritical(FIR_CORE) << lastError;
                     return false;
                 }
             } else {
-                d->lastError = m->lastError();
+                lastError = m->lastError();
                 return false;
             }
         }
@@ -416,24 +665,748 @@ bool Migrator::rollback(uint steps)
     return true;
 }
 
-bool Migrator::reset()
+bool MigratorPrivate::findMigration(const std::vector<MigrationEntry> &migrations, const QString &name)
 {
-    return rollback(std::numeric_limits<uint>::max());
+    const auto it = std::lower_bound(migrations.cbegin(), migrations.cend(), name, [](const MigrationEntry &e, const QString &n) {
+        return e.name < n;
+    });
+    if (it == migrations.cend() || it->name != name) {
+        lastError = Error(Error::InternalError, QStringLiteral("Migration \"%1\" has not been added to this migrator.").arg(name));
+        qCCritical(FIR_CORE) << lastError;
+        return false;
+    }
+    return true;
 }
 
-bool Migrator::refresh(uint steps)
+bool MigratorPrivate::loadSchema(Schema &schema)
 {
-    if (steps < 1) {
-        if (!rollback(std::numeric_limits<uint>::max())) {
-            return false;
-        }
-    } else {
-        if (!rollback(steps)) {
-            return false;
-        }
+    qCDebug(FIR_CORE, "Reading schema of %s database", qUtf8Printable(context.typeToStr()));
+    return context.dialect->loadSchema(db, schema, lastError);
+}
+
+std::unique_ptr<Migration> MigratorPrivate::diffMigration(Migrator *q, const Migrator::MigrationFactory &desired)
+{
+    if (!q->initDatabase()) {
+        return nullptr;
     }
 
-    return migrate();
+    Schema schema(context);
+    if (!loadSchema(schema)) {
+        return nullptr;
+    }
+
+    std::vector<TableDiff> diffs;
+    {
+        const std::unique_ptr<Migration> migration(desired(q));
+        const QList<Table *> tables = MigrationPrivate::get(migration.get())->declare();
+        std::vector<const TablePrivate *> declared;
+        declared.reserve(static_cast<std::size_t>(tables.size()));
+        for (Table *t : tables) {
+            const TablePrivate *td = TablePrivate::get(t);
+            if (td->operation == TablePrivate::CreateTable || td->operation == TablePrivate::CreateTableIfNotExists) {
+                declared.push_back(td);
+            }
+        }
+        diffs = SchemaDiff::compare(declared, schema);
+        qCInfo(FIR_CORE, "%i of %i declared tables differ from the database", static_cast<int>(diffs.size()), static_cast<int>(declared.size()));
+    }
+
+    // changes the database can not apply would leave the schema out of sync
+    for (const TableDiff &diff : diffs) {
+        if (diff.create) {
+            continue;
+        }
+        for (const ColumnPrivate &change : diff.changes) {
+            if (!context.dialect->checkAlterChange(diff.name, change, lastError)) {
+                qCCritical(FIR_CORE) << lastError;
+                return nullptr;
+            }
+        }
+    }
+
+    return std::unique_ptr<Migration>(new DiffMigration(q, std::move(diffs)));
+}
+
+Migrator::Migrator(QObject *parent) :
+    QObject(parent), dptr(new MigratorPrivate)
+{
+    Q_D(Migrator);
+    d->connectionName = QLatin1String(QSqlDatabase::defaultConnection);
+    d->migrationsTable = QStringLiteral("migrations");
+}
+
+Migrator::Migrator(const QString &connectionName, const QString &migrationsTable, QObject *parent) : QObject(parent), dptr(new MigratorPrivate)
+{
+    Q_D(Migrator);
+    d->connectionName = connectionName;
+    d->migrationsTable = migrationsTable;
+}
+
+Migrator::~Migrator() = default;
+
+void Migrator::setBackgroundConcurrency(int workers)
+{
+    Q_ASSERT_X(workers > 0, "set background concurrency", "at least one worker is needed");
+    Q_D(Migrator);
+    d->backgroundConcurrency = workers;
+}
+
+int Migrator::backgroundConcurrency() const
+{
+    Q_D(const Migrator);
+    return d->backgroundConcurrency;
+}
+
+void Migrator::setBackgroundThrottle(int msecs)
+{
+    Q_D(Migrator);
+    d->backgroundThrottle = std::max(0, msecs);
+}
+
+int Migrator::backgroundThrottle() const
+{
+    Q_D(const Migrator);
+    return d->backgroundThrottle;
+}
+
+void Migrator::setLockTimeout(int msecs)
+{
+    Q_D(Migrator);
+    d->executionOptions.timeout = std::max(0, msecs);
+}
+
+int Migrator::lockTimeout() const
+{
+    Q_D(const Migrator);
+    return d->executionOptions.timeout;
+}
+
+void Migrator::setRetries(int retries, int delay)
+{
+    Q_ASSERT_X(delay > 0, "set retries", "invalid delay");
+    Q_D(Migrator);
+    d->executionOptions.retries = std::max(0, retries);
+    d->executionOptions.retryDelay = delay;
+}
+
+void Migrator::setMigrationTimeout(int msecs)
+{
+    Q_D(Migrator);
+    d->executionOptions.migrationTimeout = std::max(0, msecs);
+}
+
+int Migrator::migrationTimeout() const
+{
+    Q_D(const Migrator);
+    return d->executionOptions.migrationTimeout;
+}
+
+void Migrator::cancel()
+{
+    Q_D(Migrator);
+    d->cancellation.cancel();
+}
+
+void Migrator::setLagProbe(const LagProbe &probe, qint64 maxLag, int pollInterval)
+{
+    Q_ASSERT_X(pollInterval > 0, "set lag probe", "invalid poll interval");
+    Q_D(Migrator);
+    d->lagThrottle = LagThrottle();
+    d->lagThrottle.probe = probe;
+    d->lagThrottle.maxLag = maxLag;
+    d->lagThrottle.pollInterval = pollInterval;
+}
+
+Migrator::LagProbe Migrator::replicaStatusLagProbe(const QString &replicaConnectionName)
+{
+    const BackgroundConnection replica(QSqlDatabase::database(replicaConnectionName, false));
+    return [replica, replicaConnectionName](const QSqlDatabase &db) -> qint64 {
+        Q_UNUSED(db)
+        return replicaStatusLag(replica, replicaConnectionName);
+    };
+}
+
+Migrator::LagProbe Migrator::pgStatReplicationLagProbe()
+{
+    return [](const QSqlDatabase &db) -> qint64 {
+        return pgStatReplicationLag(db);
+    };
+}
+
+qint64 Migrator::lagWaitTime() const
+{
+    Q_D(const Migrator);
+    return d->lagWait;
+}
+
+bool Migrator::waitForBackgroundMigrations(int msecs)
+{
+    Q_D(Migrator);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto &worker : d->backgroundWorkers) {
+        if (msecs < 0) {
+            worker->wait();
+        } else {
+            const qint64 remaining = msecs - timer.elapsed();
+            if (remaining <= 0 || !worker->wait(static_cast<unsigned long>(remaining))) {
+                return false;
+            }
+        }
+    }
+
+    if (d->backgroundQueue) {
+        const Error error = d->backgroundQueue->error();
+        if (error.type() != Error::NoError) {
+            d->lastError = error;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Migrator::initDatabase()
+{
+    Q_D(Migrator);
+
+    if (!d->db.isOpen()) {
+        d->db = QSqlDatabase::database(d->connectionName);
+        if (!d->db.isOpen()) {
+            d->lastError = Error(d->db.lastError(), QStringLiteral("Can not open database connection \"%1\":").arg(d->connectionName));
+            qCCritical(FIR_CORE) << d->lastError;
+            return false;
+        }
+    }
+
+    d->setDbType();
+    d->setDbVersion();
+
+    d->setDbFeatures();
+
+    return true;
+}
+
+Migrator::DatabaseType Migrator::dbType() const
+{
+    Q_D(const Migrator);
+    return d->context.type;
+}
+
+QString Migrator::dbTypeToStr() const
+{
+    Q_D(const Migrator);
+    return d->context.typeToStr();
+}
+
+QVersionNumber Migrator::dbVersion() const
+{
+    Q_D(const Migrator);
+    return d->context.version;
+}
+
+Migrator::DatabaseFeatures Migrator::dbFeatures() const
+{
+    Q_D(const Migrator);
+    return d->context.features;
+}
+
+bool Migrator::isDbFeatureAvailable(DatabaseFeatures dbFeatures) const
+{
+    Q_D(const Migrator);
+    return d->context.isFeatureAvailable(dbFeatures);
+}
+
+QString Migrator::connectionName() const
+{
+    Q_D(const Migrator);
+    return d->connectionName;
+}
+
+QString Migrator::migrationsTable() const
+{
+    Q_D(const Migrator);
+    return d->migrationsTable;
+}
+
+void Migrator::addMigrationFactory(const QString &name, const MigrationFactory &factory)
+{
+    Q_ASSERT_X(!name.isEmpty(), "add migration factory", "empty migration name");
+    Q_ASSERT_X(factory, "add migration factory", "invalid factory");
+
+    Q_D(Migrator);
+
+    for (const MigrationEntry &e : d->factories) {
+        if (e.name == name) {
+            qCWarning(FIR_CORE, "Migration \"%s\" has already been added to this migrator.", qUtf8Printable(name));
+            return;
+        }
+    }
+
+    MigrationEntry e;
+    e.name = name;
+    e.factory = factory;
+    d->factories.push_back(std::move(e));
+}
+
+void Migrator::setBaselineFactory(const QString &upTo, const MigrationFactory &factory)
+{
+    Q_ASSERT_X(!upTo.isEmpty(), "set baseline", "empty migration name");
+    Q_ASSERT_X(factory, "set baseline", "invalid factory");
+
+    Q_D(Migrator);
+    d->baseline.name = upTo;
+    d->baseline.factory = factory;
+}
+
+void Migrator::addRegisteredMigrations()
+{
+    Q_D(Migrator);
+
+    const std::vector<RegisteredMigration> &registry = migrationRegistry();
+
+    QSet<QString> names;
+    names.reserve(static_cast<int>(d->factories.size() + registry.size()));
+    for (const MigrationEntry &e : d->factories) {
+        names.insert(e.name);
+    }
+
+    d->factories.reserve(d->factories.size() + registry.size());
+    for (const RegisteredMigration &r : registry) {
+        const QString name = QString::fromLatin1(r.metaObject->className());
+        if (names.contains(name)) {
+            continue;
+        }
+        names.insert(name);
+        MigrationEntry e;
+        e.name = name;
+        e.factory = r.factory;
+        e.sourceChecksum = r.checksum;
+        d->factories.push_back(std::move(e));
+    }
+}
+
+bool Migrator::migrate()
+{
+    Q_D(Migrator);
+    return d->migrate(this, QString(), AllPhases);
+}
+
+bool Migrator::migrate(Phases phases)
+{
+    Q_D(Migrator);
+    return d->migrate(this, QString(), phases);
+}
+
+bool Migrator::migrateTo(const QString &name)
+{
+    Q_ASSERT_X(!name.isEmpty(), "migrate to", "empty migration name");
+
+    Q_D(Migrator);
+    return d->migrate(this, name, AllPhases);
+}
+
+bool Migrator::rollback(uint steps)
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    const std::vector<MigrationEntry> migrations = d->migrations(this);
+    if (migrations.empty()) {
+        qCWarning(FIR_CORE, "No migrations added to this migrator.");
+        return true;
+    }
+
+    if (!initDatabase()) {
+        return false;
+    }
+
+    if (!d->prepareMigrationsTable()) {
+        return false;
+    }
+
+    qCInfo(FIR_CORE, "Start rolling back database migrations on %s database version %s", qUtf8Printable(dbTypeToStr()), qUtf8Printable(d->context.version.toString()));
+
+    QSet<QString> appliedMigrations;
+    QSqlQuery query(d->db);
+    QString qs = QStringLiteral("SELECT migration FROM %1 WHERE %2 ORDER BY migration DESC").arg(d->migrationsTable, appliedCondition());
+    if (steps > 0) {
+        qs += QStringLiteral(" LIMIT %1").arg(steps);
+    } else {
+        qs += QStringLiteral(" LIMIT 1");
+    }
+
+    if (query.exec(qs)) {
+        while(query.next()) {
+            appliedMigrations.insert(query.value(0).toString());
+        }
+    } else {
+        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    if (appliedMigrations.empty()) {
+        qCInfo(FIR_CORE, "%s", "No migrations applied.");
+        return true;
+    }
+
+    return d->rollbackApplied(this, migrations, appliedMigrations);
+}
+
+bool Migrator::rollbackTo(const QString &name)
+{
+    Q_ASSERT_X(!name.isEmpty(), "rollback to", "empty migration name");
+
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    const std::vector<MigrationEntry> migrations = d->migrations(this);
+    if (migrations.empty()) {
+        qCWarning(FIR_CORE, "No migrations added to this migrator.");
+        return true;
+    }
+
+    if (!d->findMigration(migrations, name)) {
+        return false;
+    }
+
+    if (!initDatabase()) {
+        return false;
+    }
+
+    if (!d->prepareMigrationsTable()) {
+        return false;
+    }
+
+    qCInfo(FIR_CORE, "Start rolling back database migrations down to %s on %s database version %s", qUtf8Printable(name), qUtf8Printable(dbTypeToStr()), qUtf8Printable(d->context.version.toString()));
+
+    QSet<QString> appliedMigrations;
+    QSqlQuery query(d->db);
+    query.prepare(QStringLiteral("SELECT migration FROM %1 WHERE migration > ? AND %2").arg(d->migrationsTable, appliedCondition()));
+    query.addBindValue(name);
+    if (query.exec()) {
+        while(query.next()) {
+            appliedMigrations.insert(query.value(0).toString());
+        }
+    } else {
+        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query already applied migrations from the database:"));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    if (appliedMigrations.empty()) {
+        qCInfo(FIR_CORE, "No migrations applied after %s.", qUtf8Printable(name));
+        return true;
+    }
+
+    return d->rollbackApplied(this, migrations, appliedMigrations);
+}
+
+bool Migrator::rollbackBatch()
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    const std::vector<MigrationEntry> migrations = d->migrations(this);
+    if (migrations.empty()) {
+        qCWarning(FIR_CORE, "No migrations added to this migrator.");
+        return true;
+    }
+
+    if (!initDatabase()) {
+        return false;
+    }
+
+    if (!d->prepareMigrationsTable()) {
+        return false;
+    }
+
+    QSqlQuery query(d->db);
+    QSet<QString> batchMigrations;
+    int batch = 0;
+    if (query.exec(QStringLiteral("SELECT migration, batch FROM %1 WHERE batch = (SELECT MAX(batch) FROM %1) AND %2").arg(d->migrationsTable, appliedCondition()))) {
+        while (query.next()) {
+            batchMigrations.insert(query.value(0).toString());
+            batch = query.value(1).toInt();
+        }
+    } else {
+        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query the last batch of applied migrations from the database:"));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    if (batchMigrations.empty()) {
+        qCInfo(FIR_CORE, "%s", "No migrations applied.");
+        return true;
+    }
+
+    if (!d->checkNoBackgroundRunning()) {
+        return false;
+    }
+
+    QSet<QString> known;
+    for (const MigrationEntry &entry : migrations) {
+        known.insert(entry.name);
+    }
+    for (const QString &name : batchMigrations) {
+        if (!known.contains(name)) {
+            d->lastError = Error(Error::InternalError, QStringLiteral("Can not roll back batch %1, migration \"%2\" has not been added to this migrator.").arg(QString::number(batch), name));
+            qCCritical(FIR_CORE) << d->lastError;
+            return false;
+        }
+    }
+
+    qCInfo(FIR_CORE, "Rolling back batch %i with %i migrations on %s database version %s", batch, static_cast<int>(batchMigrations.size()), qUtf8Printable(dbTypeToStr()), qUtf8Printable(d->context.version.toString()));
+
+    QStringList rolledBack;
+    for (auto i = migrations.crbegin(); i != migrations.crend(); ++i) {
+        const MigrationEntry &entry = *i;
+        if (!batchMigrations.contains(entry.name)) {
+            continue;
+        }
+        qCInfo(FIR_CORE, "Rolling back migration %s", qUtf8Printable(entry.name));
+        std::unique_ptr<Migration> owned;
+        Migration *m = entry.instance(this, owned);
+        if (!m->d_func()->rollback(d->connectionName)) {
+            d->lastError = m->lastError();
+            // keep the bookkeeping in line with what has already been rolled back
+            if (!rolledBack.empty()) {
+                query.prepare(QStringLiteral("DELETE FROM %1 WHERE migration = ?").arg(d->migrationsTable));
+                for (const QString &name : rolledBack) {
+                    query.addBindValue(name);
+                    if (!query.exec()) {
+                        d->lastError = Error(query.lastError(), QStringLiteral("Failed to remove rolled back migration \"%1\" from the migrations table \"%2\" after rolling back \"%3\" failed:").arg(name, d->migrationsTable, entry.name));
+                        qCCritical(FIR_CORE) << d->lastError;
+                        return false;
+                    }
+                }
+            }
+            return false;
+        }
+        rolledBack << entry.name;
+    }
+
+    query.prepare(QStringLiteral("DELETE FROM %1 WHERE batch = ?").arg(d->migrationsTable));
+    query.addBindValue(batch);
+    if (!query.exec()) {
+        d->lastError = Error(query.lastError(), QStringLiteral("Failed to remove batch %1 from the migrations table \"%2\":").arg(QString::number(batch), d->migrationsTable));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    return true;
+}
+
+bool Migrator::reset()
+{
+    return rollback(std::numeric_limits<uint>::max());
+}
+
+bool Migrator::refresh(uint steps)
+{
+    if (steps < 1) {
+        if (!rollback(std::numeric_limits<uint>::max())) {
+            return false;
+        }
+    } else {
+        if (!rollback(steps)) {
+            return false;
+        }
+    }
+
+    return migrate();
+}
+
+bool Migrator::verifyChecksums()
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    const std::vector<MigrationEntry> migrations = d->migrations(this);
+
+    if (!initDatabase()) {
+        return false;
+    }
+
+    if (!d->prepareMigrationsTable()) {
+        return false;
+    }
+
+    QSqlQuery query(d->db);
+    // the checksum of the rendered SQL and the checksum of the source file, if known
+    QHash<QString, QPair<QByteArray,QByteArray>> stored;
+    // checkpoints of partially applied migrations only cover the applied statements,
+    // background migrations store the checksum of all their statements when they are queued
+    if (query.exec(QStringLiteral("SELECT migration, checksum, source_checksum FROM %1 WHERE checksum IS NOT NULL AND (%2 OR phase = %3)").arg(d->migrationsTable, appliedCondition(), QString::number(static_cast<int>(Background))))) {
+        while (query.next()) {
+            stored.insert(query.value(0).toString(), qMakePair(query.value(1).toString().toLatin1(), query.value(2).toString().toLatin1()));
+        }
+    } else {
+        d->lastError = Error(query.lastError(), QStringLiteral("Failed to query checksums of applied migrations from the database:"));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    QStringList changed;
+    for (const MigrationEntry &entry : migrations) {
+        const auto it = stored.constFind(entry.name);
+        if (it == stored.constEnd()) {
+            continue;
+        }
+        // an unchanged source file renders the same SQL, anything else has to be rendered
+        if (!entry.sourceChecksum.isEmpty() && entry.sourceChecksum == it.value().second) {
+            continue;
+        }
+        std::unique_ptr<Migration> owned;
+        const QByteArray checksum = entry.instance(this, owned)->d_func()->renderChecksum();
+        if (checksum != it.value().first) {
+            qCWarning(FIR_CORE, "Applied migration %s has been changed", qUtf8Printable(entry.name));
+            changed << entry.name;
+        }
+    }
+
+    if (!changed.empty()) {
+        d->lastError = Error(Error::InternalError, QStringLiteral("The following applied migrations have been changed: %1").arg(changed.join(QStringLiteral(", "))));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    return true;
+}
+
+QStringList Migrator::diff(const MigrationFactory &desired)
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    QStringList statements;
+    const std::unique_ptr<Migration> migration = d->diffMigration(this, desired);
+    if (migration) {
+        const QList<Table *> tables = migration->d_func()->declare();
+        for (Table *t : tables) {
+            const QString statement = TablePrivate::get(t)->queryString();
+            if (!statement.isEmpty()) {
+                statements << statement;
+            }
+        }
+        qDeleteAll(tables);
+    }
+    return statements;
+}
+
+bool Migrator::converge(const MigrationFactory &desired)
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    const std::unique_ptr<Migration> migration = d->diffMigration(this, desired);
+    if (!migration) {
+        return false;
+    }
+
+    qCInfo(FIR_CORE, "Converging %s database schema", qUtf8Printable(dbTypeToStr()));
+    if (!migration->d_func()->migrate(d->connectionName)) {
+        d->lastError = migration->lastError();
+        return false;
+    }
+
+    return true;
+}
+
+bool Migrator::addPartitionRotation(const QString &table, PartitionInterval interval, int premake, int retention, ExpiryAction action)
+{
+    Q_ASSERT_X(!table.trimmed().isEmpty(), "add partition rotation", "empty table name");
+    Q_ASSERT_X(premake >= 0, "add partition rotation", "premake can not be negative");
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    if (action == DetachExpired) {
+        if (!initDatabase()) {
+            return false;
+        }
+        if (!d->context.dialect->detachesPartitions(dbVersion())) {
+            d->lastError = Error(Error::InternalError, QStringLiteral("%1 %2 does not support detaching partitions. Can not detach the expired partitions of \"%3\".").arg(dbTypeToStr(), dbVersion().toString(), table.trimmed()));
+            qCCritical(FIR_CORE) << d->lastError;
+            return false;
+        }
+    }
+
+    PartitionRotation rotation;
+    rotation.table = table.trimmed();
+    rotation.interval = interval;
+    rotation.action = action;
+    rotation.premake = premake;
+    rotation.retention = std::max(0, retention);
+    d->partitionRotations.push_back(rotation);
+
+    return true;
+}
+
+bool Migrator::rotatePartitions()
+{
+    Q_D(Migrator);
+
+    d->lastError = Error();
+
+    if (d->partitionRotations.empty()) {
+        return true;
+    }
+
+    if (!initDatabase()) {
+        return false;
+    }
+
+    const QString partitionsQuery = d->context.dialect->partitionsQuery();
+    if (!isDbFeatureAvailable(Partitioning) || partitionsQuery.isEmpty()) {
+        d->lastError = Error(Error::InternalError, QStringLiteral("%1 %2 does not support partitioning tables.").arg(dbTypeToStr(), dbVersion().toString()));
+        qCCritical(FIR_CORE) << d->lastError;
+        return false;
+    }
+
+    QHash<QString, QStringList> existing;
+    QHash<QString, QString> catchAll;
+    {
+        QSqlQuery query(d->db);
+        if (!query.exec(partitionsQuery)) {
+            d->lastError = Error(query.lastError(), QStringLiteral("Failed to query the existing partitions:"));
+            qCCritical(FIR_CORE) << d->lastError;
+            return false;
+        }
+        while (query.next()) {
+            existing[query.value(0).toString()].append(query.value(1).toString());
+            if (query.value(2).toBool()) {
+                catchAll.insert(query.value(0).toString(), query.value(1).toString());
+            }
+        }
+    }
+
+    const QDate today = QDateTime::currentDateTimeUtc().date();
+    std::vector<PartitionChange> changes;
+    for (const PartitionRotation &rotation : d->partitionRotations) {
+        rotation.plan(today, existing.value(rotation.table), catchAll.value(rotation.table), changes);
+    }
+
+    if (changes.empty()) {
+        qCInfo(FIR_CORE, "Partitions of %i rotated tables are up to date", static_cast<int>(d->partitionRotations.size()));
+        return true;
+    }
+
+    const std::unique_ptr<Migration> migration(new RotationMigration(this, std::move(changes)));
+    if (!migration->d_func()->migrate(d->connectionName)) {
+        d->lastError = migration->lastError();
+        return false;
+    }
+
+    return true;
 }
 
 Error Migrator::lastError() const
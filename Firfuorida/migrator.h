@@ -11,18 +11,24 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QVersionNumber>
+#include <QStringList>
 #include <QFlags>
 #include "error.h"
+#include <functional>
 
 namespace Firfuorida {
 
 class MigratorPrivate;
+class Migration;
 
 /*!
  * \brief Manages multiple migrations.
  *
  * The %Migrator class manages multiple Migration objects that are children of the
- * %Migrator class.
+ * %Migrator class or that have been registered via addMigration(). Registered
+ * migrations are only constructed when they have to be applied or rolled back and
+ * are destroyed directly afterwards, so the memory used by a run does not depend on
+ * the length of the migration history.
  *
  * <h2>Example</h2>
  * example.h
@@ -99,11 +105,52 @@ public:
         EnumType            = 1 << 13, /**< Supports ENUM data type. */
         UnsignedInteger     = 1 << 14, /**< Supports unsigned integer data types. */
         CharsetOnColumn     = 1 << 15, /**< Supports character set on columns. */
-        YearType            = 1 << 16  /**< Support the YEAR data type. */
+        YearType            = 1 << 16, /**< Support the YEAR data type. */
+        Partitioning        = 1 << 17, /**< Supports partitioned tables. */
+        IndexPartOptions    = 1 << 18  /**< Supports prefix lengths and sort order on index columns. */
     };
     Q_DECLARE_FLAGS(DatabaseFeatures, DatabaseFeature)
     Q_FLAGS(DatabaseFeatures)
 
+    /*!
+     * \brief The deployment phase a Migration belongs to.
+     *
+     * Splitting migrations into phases allows rolling deployments without downtime:
+     * additive changes are applied before the new application version is deployed,
+     * destructive changes only after the old version has been shut down.
+     * \sa Migration::setPhase(), migrate(Phases)
+     */
+    enum Phase : int {
+        PreDeploy   = 1 << 0, /**< Expand: additive changes the old and the new application version can work with. This is the default. */
+        PostDeploy  = 1 << 1, /**< Contract: destructive changes like dropping columns or tables that are not used anymore. */
+        Background  = 1 << 2, /**< Long running data migrations that are run independently from the deployment. */
+        AllPhases   = PreDeploy|PostDeploy|Background /**< Migrations of all phases. */
+    };
+    Q_DECLARE_FLAGS(Phases, Phase)
+    Q_FLAGS(Phases)
+
+    /*!
+     * \brief The period covered by a single partition of a rotated table.
+     * \sa addPartitionRotation()
+     */
+    enum PartitionInterval : int {
+        Daily   = 0, /**< One partition per day. */
+        Weekly  = 1, /**< One partition per week, starting on monday. */
+        Monthly = 2, /**< One partition per month. */
+        Yearly  = 3  /**< One partition per year. */
+    };
+    Q_ENUM(PartitionInterval)
+
+    /*!
+     * \brief What happens to partitions of a rotated table that are older than the retention.
+     * \sa addPartitionRotation()
+     */
+    enum ExpiryAction : int {
+        DropExpired     = 0, /**< Drops the expired partitions together with their data. */
+        DetachExpired   = 1  /**< Detaches the expired partitions, so that they become tables of their own. */
+    };
+    Q_ENUM(ExpiryAction)
+
     /*!
      * \brief Opens and initializes the database.
      *
@@ -157,13 +204,292 @@ public:
      */
     QString migrationsTable() const;
 
+    /*!
+     * \brief Creates a new Migration object that has the given %Migrator as parent.
+     */
+    using MigrationFactory = std::function<Migration*(Migrator*)>;
+
+    /*!
+     * \brief Registers the \a factory for the migration with the class name \a name.
+     *
+     * The \a name has to be the class name of the migration created by the \a factory,
+     * it is the name that is stored in the migrationsTable(). Registering a name twice
+     * is ignored.
+     *
+     * \sa addMigration()
+     */
+    void addMigrationFactory(const QString &name, const MigrationFactory &factory);
+
+    /*!
+     * \brief Registers the migration class \a T.
+     *
+     * Other than constructing the migration with the %Migrator as parent, \a T is only
+     * instantiated by migrate() and rollback() when it is pending respectively applied,
+     * and it is destroyed right after it has been processed.
+     *
+     * \code{.cpp}
+     * auto migrator = new Firfuorida::Migrator(QStringLiteral("myDb"), QStringLiteral("migrations"));
+     * migrator->addMigration<M20190121T174100_Example>();
+     * migrator->addMigration<M20190125T101130_Example2>();
+     * migrator->migrate();
+     * \endcode
+     */
+    template<typename T>
+    void addMigration()
+    {
+        addMigrationFactory(QString::fromLatin1(T::staticMetaObject.className()), [](Migrator *parent) -> Migration* { return new T(parent); });
+    }
+
+    /*!
+     * \brief Sets the \a factory for a baseline migration that covers all migrations up to and including \a upTo.
+     *
+     * A baseline is a squashed migration whose up() function creates the consolidated schema
+     * of all migrations with a name lower or equal to \a upTo. If migrate() finds no applied
+     * migrations in the migrationsTable(), it applies the baseline instead of the covered
+     * migrations, records all covered migrations as applied at once and continues with
+     * the newer ones. Databases that already have applied migrations are migrated
+     * incrementally as before. The baseline itself is never recorded and never rolled back.
+     *
+     * \sa setBaseline()
+     */
+    void setBaselineFactory(const QString &upTo, const MigrationFactory &factory);
+
+    /*!
+     * \brief Sets the migration class \a T as baseline for all migrations up to and including \a upTo.
+     *
+     * \sa setBaselineFactory()
+     */
+    template<typename T>
+    void setBaseline(const QString &upTo)
+    {
+        setBaselineFactory(upTo, [](Migrator *parent) -> Migration* { return new T(parent); });
+    }
+
+    /*!
+     * \brief Sets the maximum number of background migrations executed in parallel to \a workers.
+     *
+     * Every worker uses its own thread and database connection. Background migrations
+     * executed in parallel must not depend on each other. The default value is \c 1.
+     * Changes take effect on the next start of the workers by migrate().
+     */
+    void setBackgroundConcurrency(int workers);
+
+    /*!
+     * \brief Returns the maximum number of background migrations executed in parallel.
+     */
+    int backgroundConcurrency() const;
+
+    /*!
+     * \brief Sets the pause between two statements of a background migration to \a msecs milliseconds.
+     *
+     * The default value is \c 0, what means no pause.
+     */
+    void setBackgroundThrottle(int msecs);
+
+    /*!
+     * \brief Returns the pause between two statements of a background migration in milliseconds.
+     */
+    int backgroundThrottle() const;
+
+    /*!
+     * \brief Waits up to \a msecs milliseconds for running background migrations to finish.
+     *
+     * If \a msecs is negative, this waits without a time limit. Returns \c true if all
+     * workers have finished and no background migration failed. If one failed, lastError()
+     * returns the error of the first failed migration. Destroying the %Migrator interrupts
+     * running background migrations after their current statement.
+     */
+    bool waitForBackgroundMigrations(int msecs = -1);
+
+    /*!
+     * \brief Limits the time every statement of a migration waits for locks to \a msecs milliseconds.
+     *
+     * A DDL statement that waits for a lock blocks all queries that are queued behind it.
+     * With a lock timeout the statement fails instead, and can be retried after other
+     * queries have been served, see setRetries(). The timeout is set on the connection
+     * before a migration is applied or rolled back and reset afterwards. Individual
+     * migrations can override it with Migration::setLockTimeout().
+     *
+     * <table>
+     * <tr><th>Database</th><th>Setting</th></tr>
+     * <tr><td>MySQL/MariaDB</td><td>lock_wait_timeout, rounded up to whole seconds</td></tr>
+     * <tr><td>PostgreSQL</td><td>lock_timeout</td></tr>
+     * <tr><td>SQLite</td><td>busy_timeout</td></tr>
+     * </table>
+     *
+     * The default value is \c 0, what keeps the timeout of the database session.
+     */
+    void setLockTimeout(int msecs);
+
+    /*!
+     * \brief Returns the lock timeout for statements of migrations in milliseconds.
+     */
+    int lockTimeout() const;
+
+    /*!
+     * \brief Retries statements that failed with a transient error up to \a retries times.
+     *
+     * Errors are classified by the native error code or SQLSTATE reported by the database,
+     * deadlocks, lock timeouts and lost connections are transient, see Error::isTransient().
+     * A lost connection is reopened before the statement is retried. The first retry waits
+     * around \a delay milliseconds, every further retry waits twice as long as the previous
+     * one. The actual delays are randomized between half and the full value, so that
+     * concurrent deployments do not retry in lockstep. The default is no retry.
+     *
+     * \note Only the failed statement is retried. Migrations that open an explicit transaction
+     * with Migration::raw() should not rely on retries, as a deadlock rolls back the whole
+     * transaction.
+     */
+    void setRetries(int retries, int delay = 500);
+
+    /*!
+     * \brief Cancels every migration that has not finished after \a msecs milliseconds.
+     *
+     * A migration that times out is cancelled like by cancel(). Individual migrations can
+     * override the timeout with Migration::setTimeout(). The default value is \c 0, what
+     * disables the timeout.
+     */
+    void setMigrationTimeout(int msecs);
+
+    /*!
+     * \brief Returns the timeout for single migrations in milliseconds.
+     */
+    int migrationTimeout() const;
+
+    /*!
+     * \brief Cancels the running migrate() or rollback() call. This function is thread-safe.
+     *
+     * The migration stops before its next statement. A statement that is currently executed
+     * is cancelled on the server side, by KILL QUERY on MySQL and MariaDB and by
+     * pg_cancel_backend() on PostgreSQL, both executed on a separate connection. On SQLite
+     * the running statement is only interrupted if the library has been built with
+     * ENABLE_SQLITE_INTERRUPT, otherwise the migration stops after it. The cancelled call
+     * returns \c false and lastError() has the Error::Cancelled category and tells the
+     * migration and statement where it stopped.
+     *
+     * Statements that have already been executed are not rolled back. Calling this function
+     * while no migration is running cancels the next migrate() or rollback() call before its
+     * first statement. Background migrations are not affected.
+     */
+    void cancel();
+
+    /*!
+     * \brief Returns the replication lag in milliseconds or a negative value if it is unknown.
+     *
+     * The probe is called with the connection that executes the migration statements,
+     * what is a separate connection for background migrations. As background migrations
+     * are executed on other threads, the probe has to be thread-safe.
+     */
+    using LagProbe = std::function<qint64(const QSqlDatabase &db)>;
+
+    /*!
+     * \brief Pauses migrations while the lag measured by \a probe exceeds \a maxLag milliseconds.
+     *
+     * The \a probe is called between the statements of a migration, but not more often
+     * than every \a pollInterval milliseconds. While the lag is too high, it is polled
+     * every \a pollInterval milliseconds. An unknown lag pauses the migration as well, as
+     * the probe can not tell a failed measurement from a replica that stopped replicating.
+     * Use cancel() to stop a migration that waits for a replica. The time spent waiting
+     * is stored for every migration in the migrationsTable() and the total time of the
+     * last run is returned by lagWaitTime(). Pass an empty \a probe to disable throttling.
+     *
+     * \code{.cpp}
+     * // pause while any replica is more than 5 seconds behind
+     * migrator->setLagProbe(Firfuorida::Migrator::replicaStatusLagProbe(QStringLiteral("replica1")), 5000);
+     * \endcode
+     */
+    void setLagProbe(const LagProbe &probe, qint64 maxLag, int pollInterval = 1000);
+
+    /*!
+     * \brief Returns a probe that reads the lag of a MySQL or MariaDB replica from SHOW REPLICA STATUS.
+     *
+     * The connection parameters are taken from the connection \a replicaConnectionName that has
+     * to be added before. Every thread calling the probe opens its own connection to the replica.
+     * The lag is unknown if the replica can not be reached or replication is not running.
+     */
+    static LagProbe replicaStatusLagProbe(const QString &replicaConnectionName);
+
+    /*!
+     * \brief Returns a probe that reads the highest replay lag of all standbys from pg_stat_replication on the primary.
+     *
+     * Requires PostgreSQL 10 or newer.
+     */
+    static LagProbe pgStatReplicationLagProbe();
+
+    /*!
+     * \brief Returns the milliseconds the last migrate() run has been paused by the lag probe.
+     *
+     * Background migrations are not included, their waiting time is only stored in the
+     * migrationsTable().
+     *
+     * \sa setLagProbe()
+     */
+    qint64 lagWaitTime() const;
+
+    /*!
+     * \brief Adds all migrations registered with FIRFUORIDA_REGISTER_MIGRATION().
+     *
+     * The registered migrations are added like by addMigration(), so they are only constructed
+     * when they have to be processed. Migrations that have already been added are skipped.
+     */
+    void addRegisteredMigrations();
+
     /*!
      * \brief Runs all migrations not already applied and return \c true on success.
      *
+     * Migrations of the Background phase are not applied directly. They are recorded as
+     * pending in the migrationsTable() and executed by low priority worker threads with
+     * their own database connections after this function has returned. The number of
+     * executed statements is stored in the migrationsTable(), so a background migration
+     * that has been interrupted, for example by a restart of the application, is resumed
+     * at its next statement by the next call to migrate(). As background migrations are
+     * executed on separate connections, they can not use Migration::executeUpFunction().
+     *
+     * The progress of the other migrations is stored in the migrationsTable() after every
+     * statement as well. Databases like MySQL can not roll back DDL statements, so if a
+     * statement fails, the ones before it stay applied. The next call to migrate() resumes
+     * such a partially applied migration at the failed statement, as long as the migration
+     * has not been changed in the meantime. Partially applied migrations are skipped by
+     * rollback(), rollbackTo() and rollbackBatch().
+     *
      * If an error occures, \c false will be returned. Use lastError() to see what
      * happened.
+     *
+     * \sa setBackgroundConcurrency(), setBackgroundThrottle(), waitForBackgroundMigrations()
      */
     bool migrate();
+    /*!
+     * \brief Runs all migrations of the given \a phases not already applied and returns \c true on success.
+     *
+     * Pending migrations of other phases are skipped, so they can be applied by a later
+     * call. As contracting changes require the expanding ones, a PostDeploy or Background
+     * migration is not applied while a PreDeploy migration ordered before it is still
+     * pending. The phase of every applied migration is recorded in the migrationsTable().
+     *
+     * <h3>Example</h3>
+     * \code{.cpp}
+     * // before the new application version is rolled out
+     * migrator->migrate(Firfuorida::Migrator::PreDeploy);
+     * // after all instances of the old version have been stopped
+     * migrator->migrate(Firfuorida::Migrator::PostDeploy);
+     * \endcode
+     *
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool migrate(Phases phases);
+    /*!
+     * \brief Runs all migrations not already applied up to and including the migration called \a name and returns \c true on success.
+     *
+     * The \a name is the class name of a migration that has been added to this %Migrator.
+     * Only the applied migrations in range are fetched from the migrationsTable(). Pending
+     * migrations that are ordered after \a name are left untouched, so that later calls
+     * can apply them step by step. A baseline is only applied if it does not cover
+     * migrations after \a name.
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool migrateTo(const QString &name);
     /*!
      * \brief Rolls back the number of migrations set by \a steps and returns \c true on success.
      *
@@ -172,6 +498,26 @@ public:
      * happened.
      */
     bool rollback(uint steps = 1);
+    /*!
+     * \brief Rolls back all applied migrations ordered after the migration called \a name and returns \c true on success.
+     *
+     * The migration called \a name itself stays applied. The migrations to roll back
+     * are fetched from the migrationsTable() with a single range query.
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool rollbackTo(const QString &name);
+    /*!
+     * \brief Rolls back all migrations applied by the last migrate() run and returns \c true on success.
+     *
+     * Every migrate() run records its migrations with a common batch number in the
+     * migrationsTable(). This rolls back the migrations of the highest batch in reverse
+     * order and removes them from the migrationsTable() with a single statement. Nothing
+     * is rolled back if one of the migrations of the batch is not known to this %Migrator.
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool rollbackBatch();
     /*!
      * \brief Rolls back all migrations and returns \c true on success.
      *
@@ -188,6 +534,105 @@ public:
      */
     bool refresh(uint steps = 0);
 
+    /*!
+     * \brief Returns \c true if no applied migration has been changed since it was applied.
+     *
+     * migrate() stores a checksum of the SQL rendered by up() for each migration in the
+     * migrationsTable() and this compares them with the checksums of the added migrations,
+     * fetched with a single query. The SQL is rendered without executing it. Migrations applied
+     * by older versions or covered by a baseline have no checksum and are skipped. The names of
+     * changed migrations are reported by lastError().
+     *
+     * Migrations registered with FIRFUORIDA_REGISTER_MIGRATION() in source files passed to
+     * the firfuorida_migration_checksums() CMake function additionally store the checksum of
+     * their source file. If it is unchanged, up() is not called. A changed source file only
+     * means that the SQL has to be rendered, so edits that do not change the SQL are not
+     * reported.
+     */
+    bool verifyChecksums();
+
+    /*!
+     * \brief Returns the statements that converge the database to the schema declared by the migration created by \a desired.
+     *
+     * The desired schema is declared by the create() and createTableIfNotExists() calls
+     * in the up() function of the migration. The current schema is read from the database
+     * with a fixed number of queries and compared table by table. Tables whose normalized
+     * definitions hash to the same value are skipped, all other changes are combined into
+     * one ALTER TABLE statement per table that adds, drops and modifies columns, indexes
+     * and foreign keys. Declared tables missing in the database are created, tables that
+     * are not declared are left untouched. Nothing is executed and nothing is recorded in
+     * the migrationsTable().
+     *
+     * An empty list is returned if the database already matches or if an error occured,
+     * use lastError() to distinguish both cases.
+     *
+     * \sa converge()
+     */
+    QStringList diff(const MigrationFactory &desired);
+
+    /*!
+     * \brief Returns the statements that converge the database to the schema declared by migration class \a T.
+     *
+     * \sa diff(const MigrationFactory &desired)
+     */
+    template<typename T>
+    QStringList diff()
+    {
+        return diff([](Migrator *parent) -> Migration* { return new T(parent); });
+    }
+
+    /*!
+     * \brief Executes the statements returned by diff() and returns \c true on success.
+     *
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool converge(const MigrationFactory &desired);
+
+    /*!
+     * \brief Converges the database to the schema declared by migration class \a T.
+     *
+     * \sa converge(const MigrationFactory &desired)
+     */
+    template<typename T>
+    bool converge()
+    {
+        return converge([](Migrator *parent) -> Migration* { return new T(parent); });
+    }
+
+    /*!
+     * \brief Declares the rotation of the time partitions of \a table, applied by rotatePartitions().
+     *
+     * The table has to be partitioned by range over a single date or datetime column, see
+     * Table::partitionByRange(). Every partition covers one \a interval and is named after
+     * the table with \c _p and the start of the interval appended, like \c events_p20250301
+     * for daily and weekly, \c events_p202503 for monthly and \c events_p2025 for yearly
+     * partitions. The partition of the current interval and the next \a premake ones are
+     * created in advance. Partitions ending more than \a retention intervals before the
+     * current one are handled by \a action, a \a retention of \c 0 keeps all partitions.
+     * Partitions that do not follow the naming scheme are never touched.
+     *
+     * On MySQL and MariaDB new partitions can only be added above the existing ones. If
+     * the table has a partition up to MAXVALUE, new partitions are split off from it.
+     * Detaching expired partitions is only supported by MariaDB 10.7 and newer, \c false
+     * is returned for \a action DetachExpired on other versions and MySQL. Use lastError()
+     * to see what happened.
+     */
+    bool addPartitionRotation(const QString &table, PartitionInterval interval, int premake, int retention = 0, ExpiryAction action = DropExpired);
+
+    /*!
+     * \brief Creates the missing and removes the expired partitions of all tables declared by addPartitionRotation().
+     *
+     * The existing partitions of all tables are read with a single catalog query, only
+     * missing and expired partitions are changed, so this is cheap to call on every
+     * deployment or regularly from a scheduler. The changes are not recorded in the
+     * migrationsTable(). The current interval is determined by the current UTC date.
+     *
+     * If an error occures, \c false will be returned. Use lastError() to see what
+     * happened.
+     */
+    bool rotatePartitions();
+
     /*!
      * \brief Returns error information about the last error (if any) that occurred with this migrator.
      */
@@ -202,5 +647,6 @@ FIRFUORIDA_EXPORT QVersionNumber version();
 }
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Firfuorida::Migrator::DatabaseFeatures)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Firfuorida::Migrator::Phases)
 
 #endif // MIGRATOR_H
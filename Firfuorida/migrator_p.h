@@ -7,22 +7,173 @@
 #define MIGRATOR_P_H
 
 #include "migrator.h"
+#include "dialect_p.h"
+#include "lagthrottle_p.h"
+#include "cancellation_p.h"
+#include "partitionrotation_p.h"
+#include <QSet>
+#include <QThread>
+#include <QStringList>
+#include <memory>
+#include <vector>
 
 namespace Firfuorida {
 
+class BackgroundQueue;
+
+/*!
+ * \internal
+ * \brief Information about the used database system.
+ *
+ * The context and its Dialect are determined by Migrator::initDatabase(). Every Table
+ * takes a copy of it when it is created and shares it with its columns,
+ * so rendering does not have to walk up the QObject parent chain.
+ */
+class DbContext
+{
+public:
+    QString typeToStr() const;
+    bool isFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const { return (features & static_cast<int>(dbFeatures)) != 0; }
+
+    QVersionNumber version;
+    Migrator::DatabaseType type = Migrator::Invalid;
+    Migrator::DatabaseFeatures features = Migrator::NoFeatures;
+    const Dialect *dialect = Dialect::forType(Migrator::Invalid);
+};
+
+/*!
+ * \internal
+ * \brief Timeout and retry settings of a migration run.
+ */
+class ExecutionOptions
+{
+public:
+    // lock timeout in milliseconds, 0 keeps the timeout of the session
+    int timeout = 0;
+    int retries = 0;
+    // milliseconds before the first retry, doubled for every further retry
+    int retryDelay = 500;
+    // milliseconds a single migration may take, 0 disables the timeout
+    int migrationTimeout = 0;
+};
+
+/*!
+ * \internal
+ * \brief A migration that is either a child of the Migrator or created by a registered factory.
+ */
+class MigrationEntry
+{
+public:
+    /*!
+     * \brief Returns the migration, creating it if needed.
+     *
+     * Migrations created by the factory are owned by \a owned and are destroyed
+     * together with it.
+     */
+    Migration *instance(Migrator *migrator, std::unique_ptr<Migration> &owned) const;
+
+    QString name;
+    Migrator::MigrationFactory factory;
+    // hex encoded MD5 over the source file of a registered migration, empty if not known
+    QByteArray sourceChecksum;
+    Migration *migration = nullptr;
+};
+
 class MigratorPrivate
 {
 public:
+    static MigratorPrivate *get(Migrator *q) { return q->d_func(); }
+
+    /*!
+     * \brief Returns the child migrations and the registered ones, sorted by name.
+     */
+    std::vector<MigrationEntry> migrations(const Migrator *q) const;
+
+    /*!
+     * \brief Creates the migrations table or adds bookkeeping columns missing in tables created by older versions.
+     */
+    bool prepareMigrationsTable();
+
+    /*!
+     * \brief Applies the baseline and records the covered \a migrations in \a applied and the migrations table.
+     */
+    bool applyBaseline(Migrator *q, const std::vector<MigrationEntry> &migrations, QSet<QString> &applied, int batch);
+
+    /*!
+     * \brief Inserts all \a names as part of \a batch into the migrations table using prepared multi row inserts.
+     */
+    bool recordApplied(const QStringList &names, int batch);
+
+    /*!
+     * \brief Applies all pending migrations of the given \a phases, or only the ones with a name up to and including \a upTo if it is not empty.
+     */
+    bool migrate(Migrator *q, const QString &upTo, Migrator::Phases phases);
+
+    /*!
+     * \brief Rolls back the \a applied ones of the \a migrations in reverse order and removes them from the migrations table.
+     */
+    bool rollbackApplied(Migrator *q, const std::vector<MigrationEntry> &migrations, const QSet<QString> &applied);
+
+    /*!
+     * \brief Records the background \a migration as pending with a progress of \c 0 instead of applying it.
+     */
+    bool queueBackground(const QString &name, Migration *migration, int batch);
+
+    /*!
+     * \brief Starts workers for all background migrations with a progress in the migrations table.
+     *
+     * This also resumes background migrations that have been interrupted by a restart.
+     * Does nothing if workers are still running.
+     */
+    bool startBackground(Migrator *q, const std::vector<MigrationEntry> &migrations);
+
+    bool isBackgroundRunning() const;
+
+    /*!
+     * \brief Returns \c false and sets lastError if background migrations are running.
+     */
+    bool checkNoBackgroundRunning();
+
+    /*!
+     * \brief Returns \c true if \a name is one of the \a migrations, otherwise sets lastError.
+     */
+    bool findMigration(const std::vector<MigrationEntry> &migrations, const QString &name);
+
+    /*!
+     * \brief Reads tables, columns, indexes and foreign keys of the connected database into \a schema.
+     */
+    bool loadSchema(Schema &schema);
+
+    /*!
+     * \brief Returns a migration that converges the database to the tables declared by the migration created by \a desired.
+     *
+     * Returns a \c nullptr on error.
+     */
+    std::unique_ptr<Migration> diffMigration(Migrator *q, const Migrator::MigrationFactory &desired);
+
     void setDbType();
     void setDbVersion();
+    void setDbFeatures();
 
     Error lastError;
     QSqlDatabase db;
     QString connectionName;
     QString migrationsTable;
-    QVersionNumber dbVersion;
-    Migrator::DatabaseType dbType = Migrator::Invalid;
-    Migrator::DatabaseFeatures dbFeatures = Migrator::NoFeatures;
+    DbContext context;
+    std::vector<MigrationEntry> factories;
+    std::vector<PartitionRotation> partitionRotations;
+    MigrationEntry baseline;
+    LagThrottle lagThrottle;
+    ExecutionOptions executionOptions;
+    Cancellation cancellation;
+    // milliseconds the last migrate() has been paused by the lagThrottle
+    qint64 lagWait = 0;
+    // destroyed first, the workers interrupt themselves on destruction
+    std::vector<std::unique_ptr<QThread>> backgroundWorkers;
+    // jobs of the last started workers, keeps the first error of a failed job
+    std::shared_ptr<BackgroundQueue> backgroundQueue;
+    int backgroundConcurrency = 1;
+    int backgroundThrottle = 0;
 };
 
 }
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "partitionrotation_p.h"
+#include "table_p.h"
+#include <QSet>
+#include <algorithm>
+#include <utility>
+#include "logging.h"
+
+using namespace Firfuorida;
+
+void PartitionRotation::plan(const QDate &today, const QStringList &existing, const QString &catchAll, std::vector<PartitionChange> &changes) const
+{
+    QSet<QString> names;
+    for (const QString &name : existing) {
+        names.insert(name);
+    }
+
+    const QDate current = periodStart(today);
+
+    for (int i = 0; i <= premake; ++i) {
+        const QDate from = addPeriods(current, i);
+        const QString name = partitionName(from);
+        if (!names.contains(name)) {
+            qCInfo(FIR_CORE, "Adding partition %s to table %s", qUtf8Printable(name), qUtf8Printable(table));
+            changes.push_back(PartitionChange{table, name, catchAll, from, addPeriods(from, 1), PartitionChange::Add});
+        }
+    }
+
+    if (retention <= 0) {
+        return;
+    }
+
+    const QDate cutoff = addPeriods(current, -retention);
+    std::vector<std::pair<QDate, QString>> expired;
+    for (const QString &name : existing) {
+        const QDate from = partitionStart(name);
+        if (from.isValid() && addPeriods(from, 1) <= cutoff) {
+            expired.emplace_back(from, name);
+        }
+    }
+    std::sort(expired.begin(), expired.end());
+
+    const PartitionChange::Operation operation = action == Migrator::DetachExpired ? PartitionChange::Detach : PartitionChange::Drop;
+    for (const auto &e : expired) {
+        qCInfo(FIR_CORE, "%s expired partition %s of table %s", operation == PartitionChange::Detach ? "Detaching" : "Dropping", qUtf8Printable(e.second), qUtf8Printable(table));
+        changes.push_back(PartitionChange{table, e.second, QString(), QDate(), QDate(), operation});
+    }
+}
+
+QDate PartitionRotation::periodStart(const QDate &date) const
+{
+    switch (interval) {
+    case Migrator::Daily:
+        return date;
+    case Migrator::Weekly:
+        return date.addDays(1 - date.dayOfWeek());
+    case Migrator::Monthly:
+        return QDate(date.year(), date.month(), 1);
+    case Migrator::Yearly:
+        return QDate(date.year(), 1, 1);
+    }
+    return date;
+}
+
+QDate PartitionRotation::addPeriods(const QDate &start, int periods) const
+{
+    switch (interval) {
+    case Migrator::Daily:
+        return start.addDays(periods);
+    case Migrator::Weekly:
+        return start.addDays(7 * periods);
+    case Migrator::Monthly:
+        return start.addMonths(periods);
+    case Migrator::Yearly:
+        return start.addYears(periods);
+    }
+    return start;
+}
+
+QString PartitionRotation::nameFormat() const
+{
+    switch (interval) {
+    case Migrator::Monthly:
+        return QStringLiteral("yyyyMM");
+    case Migrator::Yearly:
+        return QStringLiteral("yyyy");
+    default:
+        return QStringLiteral("yyyyMMdd");
+    }
+}
+
+QString PartitionRotation::partitionName(const QDate &start) const
+{
+    return table + QLatin1String("_p") + start.toString(nameFormat());
+}
+
+QDate PartitionRotation::partitionStart(const QString &name) const
+{
+    const QString prefix = table + QLatin1String("_p");
+    if (!name.startsWith(prefix, Qt::CaseInsensitive)) {
+        return QDate();
+    }
+    const QDate start = QDate::fromString(name.mid(prefix.size()), nameFormat());
+    // not created by the rotation if it is not the start of a period
+    if (!start.isValid() || periodStart(start) != start) {
+        return QDate();
+    }
+    return start;
+}
+
+RotationMigration::RotationMigration(Migrator *parent, std::vector<PartitionChange> &&changes) :
+    Migration(parent), m_changes(std::move(changes))
+{
+
+}
+
+void RotationMigration::up()
+{
+    Table *t = nullptr;
+    for (const PartitionChange &change : m_changes) {
+        if (!t || t->objectName() != change.table) {
+            t = table(change.table);
+        }
+        if (change.operation == PartitionChange::Add && !change.reorganize.isEmpty()) {
+            PartitionPrivate p;
+            p.name = change.name;
+            p.from = change.from;
+            p.to = change.to;
+            p.reorganize = change.reorganize;
+            TablePrivate::get(t)->addPartition(std::move(p));
+        } else if (change.operation == PartitionChange::Add) {
+            t->rangePartition(change.name, change.from, change.to);
+        } else if (change.operation == PartitionChange::Detach) {
+            t->detachPartition(change.name);
+        } else {
+            t->dropPartition(change.name);
+        }
+    }
+}
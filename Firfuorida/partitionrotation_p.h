@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_PARTITIONROTATION_P_H
+#define FIRFUORIDA_PARTITIONROTATION_P_H
+
+#include "migration.h"
+#include "migrator.h"
+#include <QDate>
+#include <QStringList>
+#include <vector>
+
+namespace Firfuorida {
+
+/*!
+ * \internal
+ * \brief A single partition to add to or to remove from a rotated table.
+ */
+class PartitionChange
+{
+public:
+    enum Operation : quint8 {
+        Add,
+        Drop,
+        Detach
+    };
+
+    QString table;
+    QString name;
+    // the catch-all partition added partitions are split off from
+    QString reorganize;
+    // bounds of added partitions
+    QDate from;
+    QDate to;
+    Operation operation = Add;
+};
+
+/*!
+ * \internal
+ * \brief The declared rotation of the time partitions of a range partitioned table.
+ *
+ * Partitions are named after the table with \c _p and the start of their period
+ * appended, like \c events_p202503 for monthly partitions. Only partitions following
+ * this scheme are considered, so that manually created ones are never dropped.
+ */
+class PartitionRotation
+{
+public:
+    /*!
+     * \brief Appends the partitions missing and expired at \a today to \a changes.
+     *
+     * \a existing are the names of the partitions the table already has. Missing
+     * partitions are added in ascending order, as MySQL only accepts new range
+     * partitions above the existing ones, followed by the expired ones. If the table
+     * has the \a catchAll partition up to MAXVALUE, new partitions are split off from it.
+     */
+    void plan(const QDate &today, const QStringList &existing, const QString &catchAll, std::vector<PartitionChange> &changes) const;
+
+    QString table;
+    Migrator::PartitionInterval interval = Migrator::Monthly;
+    Migrator::ExpiryAction action = Migrator::DropExpired;
+    // number of periods created in advance
+    int premake = 0;
+    // number of past periods kept, 0 keeps all
+    int retention = 0;
+
+private:
+    QDate periodStart(const QDate &date) const;
+    QDate addPeriods(const QDate &start, int periods) const;
+    QString nameFormat() const;
+    QString partitionName(const QDate &start) const;
+    QDate partitionStart(const QString &name) const;
+};
+
+/*!
+ * \internal
+ * \brief Executes partition changes, used by Migrator::rotatePartitions().
+ */
+class RotationMigration : public Migration
+{
+public:
+    RotationMigration(Migrator *parent, std::vector<PartitionChange> &&changes);
+    ~RotationMigration() override = default;
+
+protected:
+    void up() override;
+    void down() override {}
+
+private:
+    std::vector<PartitionChange> m_changes;
+};
+
+}
+
+#endif // FIRFUORIDA_PARTITIONROTATION_P_H
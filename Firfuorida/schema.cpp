@@ -0,0 +1,671 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "schema_p.h"
+#include "dialect_p.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSet>
+#include <algorithm>
+#include <utility>
+#include "logging.h"
+
+using namespace Firfuorida;
+
+namespace {
+
+// types that share their name with other types in a dialect are resolved to these first
+constexpr ColumnPrivate::Type preferredTypes[] = {
+    ColumnPrivate::Int,
+    ColumnPrivate::BigInt,
+    ColumnPrivate::SmallInt,
+    ColumnPrivate::Double,
+    ColumnPrivate::Numeric,
+    ColumnPrivate::Timestamp,
+    ColumnPrivate::Blob,
+    ColumnPrivate::Text,
+    ColumnPrivate::Boolean
+};
+
+bool execSchemaQuery(QSqlQuery &query, const QString &sql, Error &error)
+{
+    if (Q_UNLIKELY(!query.exec(sql))) {
+        error = Error(query.lastError(), QStringLiteral("Failed to read the database schema:"));
+        qCCritical(FIR_CORE) << error;
+        return false;
+    }
+    return true;
+}
+
+QStringList parseValues(const QString &values)
+{
+    QStringList list;
+    QString current;
+    bool quoted = false;
+    for (int i = 0; i < values.size(); ++i) {
+        const QChar c = values.at(i);
+        if (c == QLatin1Char('\'')) {
+            if (quoted && i + 1 < values.size() && values.at(i + 1) == QLatin1Char('\'')) {
+                current.append(c);
+                ++i;
+            } else {
+                quoted = !quoted;
+            }
+        } else if (quoted) {
+            current.append(c);
+        } else if (c == QLatin1Char(',')) {
+            list.append(current);
+            current.clear();
+        }
+    }
+    if (!values.trimmed().isEmpty()) {
+        list.append(current);
+    }
+    return list;
+}
+
+QString referentialAction(const QVariant &action)
+{
+    const QString str = action.toString().toUpper();
+    // NO ACTION is the default and therefore not part of declared foreign keys
+    return str == QLatin1String("NO ACTION") ? QString() : str;
+}
+
+/*!
+ * \internal
+ * \brief Replaces primary keys on a single auto increment column by the inline column attribute.
+ *
+ * Auto increment columns are rendered with PRIMARY KEY, so this is how they are declared.
+ */
+void inlineAutoIncrementPrimaryKeys(Schema &schema)
+{
+    for (SchemaTable &table : schema.tables) {
+        auto isInline = [&table](const ColumnPrivate &key) {
+            if (key.type != ColumnPrivate::PrimaryKey || key.constraintCols.size() != 1) {
+                return false;
+            }
+            const ColumnPrivate *col = table.column(key.constraintCols.first());
+            return col && col->_autoIncrement;
+        };
+        table.columns.erase(std::remove_if(table.columns.begin(), table.columns.end(), isInline), table.columns.end());
+    }
+}
+
+/*!
+ * \internal
+ * \brief Collects consecutive rows of the same table and key into one ColumnPrivate.
+ */
+class KeyCollector
+{
+public:
+    explicit KeyCollector(Schema &schema) : m_schema(schema) {}
+
+    /*!
+     * \brief Returns the key for \a tableName and \a keyName, creating it with \a type on change.
+     *
+     * Returns \c nullptr if the table is not part of the schema.
+     */
+    ColumnPrivate *key(const QString &tableName, const QString &keyName, ColumnPrivate::Type type)
+    {
+        if (tableName != m_tableName || keyName != m_keyName) {
+            m_tableName = tableName;
+            m_keyName = keyName;
+            m_table = m_schema.table(tableName);
+            m_index = m_table ? m_table->columns.size() : 0;
+            if (m_table) {
+                m_schema.addColumn(m_table, QString(), type);
+            }
+        }
+        return m_table ? &m_table->columns[m_index] : nullptr;
+    }
+
+private:
+    Schema &m_schema;
+    QString m_tableName;
+    QString m_keyName;
+    SchemaTable *m_table = nullptr;
+    std::size_t m_index = 0;
+};
+
+}
+
+const ColumnPrivate *SchemaTable::column(const QString &name) const
+{
+    for (const ColumnPrivate &col : columns) {
+        if (col.name == name) {
+            return &col;
+        }
+    }
+    return nullptr;
+}
+
+ColumnPrivate *SchemaTable::column(const QString &name)
+{
+    return const_cast<ColumnPrivate *>(static_cast<const SchemaTable *>(this)->column(name));
+}
+
+const SchemaTable *Schema::table(const QString &name) const
+{
+    const auto it = m_tableIndex.constFind(name);
+    return it != m_tableIndex.constEnd() ? &tables[it.value()] : nullptr;
+}
+
+SchemaTable *Schema::table(const QString &name)
+{
+    const auto it = m_tableIndex.constFind(name);
+    return it != m_tableIndex.constEnd() ? &tables[it.value()] : nullptr;
+}
+
+SchemaTable *Schema::addTable(const QString &name)
+{
+    SchemaTable *t = table(name);
+    if (!t) {
+        m_tableIndex.insert(name, tables.size());
+        tables.emplace_back();
+        t = &tables.back();
+        t->name = name;
+    }
+    return t;
+}
+
+ColumnPrivate *Schema::addColumn(SchemaTable *table, const QString &name, ColumnPrivate::Type type)
+{
+    table->columns.emplace_back();
+    ColumnPrivate *c = &table->columns.back();
+    c->name = name;
+    c->type = type;
+    c->context = &context;
+    return c;
+}
+
+void Schema::setTypeFromName(ColumnPrivate *column, const QString &typeName) const
+{
+    const QString trimmed = typeName.trimmed();
+    QString base = trimmed;
+    QString params;
+    QString attributes;
+
+    const int open = trimmed.indexOf(QLatin1Char('('));
+    const int close = trimmed.lastIndexOf(QLatin1Char(')'));
+    if (open > 0 && close > open) {
+        base = trimmed.left(open).trimmed();
+        params = trimmed.mid(open + 1, close - open - 1).trimmed();
+        attributes = trimmed.mid(close + 1);
+    } else {
+        // MySQL 8.0.19 and newer omit the display width but keep the attributes
+        for (const QLatin1String attribute : {QLatin1String(" unsigned"), QLatin1String(" zerofill")}) {
+            const int pos = base.indexOf(attribute, 0, Qt::CaseInsensitive);
+            if (pos > 0) {
+                attributes.append(base.mid(pos));
+                base.truncate(pos);
+            }
+        }
+    }
+
+    base = base.toUpper();
+    attributes = attributes.toUpper();
+    if (attributes.contains(QLatin1String("UNSIGNED"))) {
+        column->_unsigned = true;
+    }
+
+    column->type = ColumnPrivate::Invalid;
+    const TypeMapping *mappings = context.dialect->typeMappings();
+    if (!mappings) {
+        return;
+    }
+
+    const QString withParams = base % QLatin1Char('(') % params % QLatin1Char(')');
+    auto matches = [&](ColumnPrivate::Type type, bool full) -> bool {
+        const TypeMapping &mapping = mappings[type];
+        if (!mapping.name || mapping.params == TypeParams::Unsupported) {
+            return false;
+        }
+        return full ? withParams == QLatin1String(mapping.name) : base == QLatin1String(mapping.name);
+    };
+
+    auto find = [&](bool full) -> ColumnPrivate::Type {
+        for (ColumnPrivate::Type type : preferredTypes) {
+            if (matches(type, full)) {
+                return type;
+            }
+        }
+        for (quint8 type = ColumnPrivate::Invalid + 1; type < ColumnPrivate::Key; ++type) {
+            if (matches(static_cast<ColumnPrivate::Type>(type), full)) {
+                return static_cast<ColumnPrivate::Type>(type);
+            }
+        }
+        return ColumnPrivate::Invalid;
+    };
+
+    if (!params.isEmpty()) {
+        column->type = find(true);
+        if (column->type != ColumnPrivate::Invalid) {
+            return;
+        }
+    }
+
+    column->type = find(false);
+    if (column->type == ColumnPrivate::Invalid) {
+        qCDebug(FIR_CORE, "Can not map data type %s of column \"%s\".", qUtf8Printable(typeName), qUtf8Printable(column->name));
+        return;
+    }
+
+    if (params.isEmpty()) {
+        return;
+    }
+
+    switch (mappings[column->type].params) {
+    case TypeParams::DisplayWidth:
+        column->displayWidth = params.toUInt();
+        break;
+    case TypeParams::PrecisionScale:
+    {
+        const QStringList parts = params.split(QLatin1Char(','));
+        column->precision = parts.at(0).trimmed().toUInt();
+        column->scale = parts.size() > 1 ? parts.at(1).trimmed().toUInt() : 0;
+    }
+        break;
+    case TypeParams::Length:
+        column->length = params.toUInt();
+        break;
+    case TypeParams::Values:
+        column->enumSet = parseValues(params);
+        break;
+    default:
+        break;
+    }
+}
+
+QVariant Schema::defaultFromExpression(const QString &expr)
+{
+    if (expr.isNull()) {
+        return QVariant();
+    }
+
+    QString str = expr.trimmed();
+
+    // PostgreSQL appends type casts like 'foo'::character varying
+    const int cast = str.lastIndexOf(QLatin1String("::"));
+    if (cast > 0 && !str.mid(cast).contains(QLatin1Char('\''))) {
+        str.truncate(cast);
+    }
+
+    if (str.size() >= 2 && str.startsWith(QLatin1Char('\'')) && str.endsWith(QLatin1Char('\''))) {
+        str = str.mid(1, str.size() - 2);
+        str.replace(QLatin1String("''"), QLatin1String("'"));
+        return str;
+    }
+
+    if (str.compare(QLatin1String("NULL"), Qt::CaseInsensitive) == 0) {
+        return QVariant();
+    }
+
+    return str;
+}
+
+bool Firfuorida::loadMySqlSchema(QSqlDatabase &db, Schema &schema, Error &error)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT TABLE_NAME, ENGINE, TABLE_COLLATION, TABLE_COMMENT "
+                                               "FROM information_schema.TABLES "
+                                               "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_TYPE = 'BASE TABLE' "
+                                               "ORDER BY TABLE_NAME"), error)) {
+        return false;
+    }
+    while (query.next()) {
+        SchemaTable *table = schema.addTable(query.value(0).toString());
+        table->engine = query.value(1).toString();
+        table->collation = query.value(2).toString();
+        table->comment = query.value(3).toString();
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT TABLE_NAME, COLUMN_NAME, COLUMN_TYPE, IS_NULLABLE, COLUMN_DEFAULT, EXTRA, "
+                                               "CHARACTER_SET_NAME, COLLATION_NAME, COLUMN_COMMENT "
+                                               "FROM information_schema.COLUMNS "
+                                               "WHERE TABLE_SCHEMA = DATABASE() "
+                                               "ORDER BY TABLE_NAME, ORDINAL_POSITION"), error)) {
+        return false;
+    }
+    // MariaDB 10.2.7 and newer return the default as SQL expression, MySQL returns the plain value
+    const bool defaultIsExpression = schema.context.type == Migrator::MariaDB && schema.context.version >= QVersionNumber(10, 2, 7);
+    while (query.next()) {
+        SchemaTable *table = schema.table(query.value(0).toString());
+        if (!table) {
+            continue;
+        }
+        ColumnPrivate *c = schema.addColumn(table, query.value(1).toString(), ColumnPrivate::Invalid);
+        schema.setTypeFromName(c, query.value(2).toString());
+        c->_nullable = query.value(3).toString() == QLatin1String("YES");
+        const QVariant defVal = query.value(4);
+        if (!defVal.isNull()) {
+            c->defVal = defaultIsExpression ? Schema::defaultFromExpression(defVal.toString()) : defVal.toString();
+        }
+        c->_autoIncrement = query.value(5).toString().contains(QLatin1String("auto_increment"), Qt::CaseInsensitive);
+        c->charset = query.value(6).toString();
+        c->collation = query.value(7).toString();
+        c->comment = query.value(8).toString();
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT TABLE_NAME, INDEX_NAME, NON_UNIQUE, COLUMN_NAME, INDEX_TYPE, SUB_PART "
+                                               "FROM information_schema.STATISTICS "
+                                               "WHERE TABLE_SCHEMA = DATABASE() "
+                                               "ORDER BY TABLE_NAME, INDEX_NAME, SEQ_IN_INDEX"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            const QString indexName = query.value(1).toString();
+            const QString indexType = query.value(4).toString();
+            ColumnPrivate::Type type = ColumnPrivate::Key;
+            if (indexName == QLatin1String("PRIMARY")) {
+                type = ColumnPrivate::PrimaryKey;
+            } else if (indexType == QLatin1String("FULLTEXT")) {
+                type = ColumnPrivate::FulltextIndex;
+            } else if (indexType == QLatin1String("SPATIAL")) {
+                type = ColumnPrivate::SpatialIndex;
+            } else if (query.value(2).toInt() == 0) {
+                type = ColumnPrivate::UniqueKey;
+            }
+            ColumnPrivate *key = collector.key(query.value(0).toString(), indexName, type);
+            if (!key) {
+                continue;
+            }
+            if (type != ColumnPrivate::PrimaryKey) {
+                key->indexName = indexName;
+            }
+            key->constraintCols.append(query.value(3).toString());
+            // some versions report a prefix length for spatial indexes that can not be declared
+            const QVariant subPart = query.value(5);
+            if (!subPart.isNull() && type != ColumnPrivate::FulltextIndex && type != ColumnPrivate::SpatialIndex) {
+                key->indexParts.resize(static_cast<std::size_t>(key->constraintCols.size()));
+                key->indexParts.back().length = subPart.toUInt();
+            }
+        }
+    }
+
+    inlineAutoIncrementPrimaryKeys(schema);
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT k.TABLE_NAME, k.CONSTRAINT_NAME, k.COLUMN_NAME, k.REFERENCED_TABLE_NAME, k.REFERENCED_COLUMN_NAME, "
+                                               "r.UPDATE_RULE, r.DELETE_RULE "
+                                               "FROM information_schema.KEY_COLUMN_USAGE AS k "
+                                               "JOIN information_schema.REFERENTIAL_CONSTRAINTS AS r "
+                                               "ON r.CONSTRAINT_SCHEMA = k.CONSTRAINT_SCHEMA AND r.CONSTRAINT_NAME = k.CONSTRAINT_NAME AND r.TABLE_NAME = k.TABLE_NAME "
+                                               "WHERE k.TABLE_SCHEMA = DATABASE() AND k.REFERENCED_TABLE_NAME IS NOT NULL "
+                                               "ORDER BY k.TABLE_NAME, k.CONSTRAINT_NAME, k.ORDINAL_POSITION"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            const QString constraintName = query.value(1).toString();
+            ColumnPrivate *fk = collector.key(query.value(0).toString(), constraintName, ColumnPrivate::ForeignKey);
+            if (!fk) {
+                continue;
+            }
+            fk->name = constraintName;
+            fk->constraintCols.append(query.value(2).toString());
+            fk->referenceTable = query.value(3).toString();
+            fk->referenceCols.append(query.value(4).toString());
+            fk->onUpdate = referentialAction(query.value(5));
+            fk->onDelete = referentialAction(query.value(6));
+        }
+    }
+
+    return true;
+}
+
+bool Firfuorida::loadSqliteSchema(QSqlDatabase &db, Schema &schema, Error &error)
+{
+    if (schema.context.version < QVersionNumber(3, 16, 0)) {
+        error = Error(Error::InternalError, QStringLiteral("Reading the database schema requires SQLite 3.16.0 or newer."));
+        qCCritical(FIR_CORE) << error;
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT name, sql FROM sqlite_master "
+                                               "WHERE type = 'table' AND substr(name, 1, 7) <> 'sqlite_' "
+                                               "ORDER BY name"), error)) {
+        return false;
+    }
+    QSet<QString> autoIncrementTables;
+    while (query.next()) {
+        const QString name = query.value(0).toString();
+        schema.addTable(name);
+        if (query.value(1).toString().contains(QLatin1String("AUTOINCREMENT"), Qt::CaseInsensitive)) {
+            autoIncrementTables.insert(name);
+        }
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT m.name, p.name, p.type, p.\"notnull\", p.dflt_value, p.pk "
+                                               "FROM sqlite_master AS m JOIN pragma_table_info(m.name) AS p "
+                                               "WHERE m.type = 'table' AND substr(m.name, 1, 7) <> 'sqlite_' "
+                                               "ORDER BY m.name, p.cid"), error)) {
+        return false;
+    }
+    {
+        SchemaTable *table = nullptr;
+        std::vector<std::pair<int, QString>> pkCols;
+
+        // the primary key is reported per column, an auto increment column gets it inline
+        auto addPrimaryKey = [&schema, &autoIncrementTables, &pkCols](SchemaTable *t) {
+            if (!t || pkCols.empty()) {
+                return;
+            }
+            std::sort(pkCols.begin(), pkCols.end());
+            if (pkCols.size() == 1 && autoIncrementTables.contains(t->name)) {
+                t->column(pkCols.front().second)->_autoIncrement = true;
+            } else {
+                ColumnPrivate *pk = schema.addColumn(t, QString(), ColumnPrivate::PrimaryKey);
+                for (const auto &col : pkCols) {
+                    pk->constraintCols.append(col.second);
+                }
+            }
+            pkCols.clear();
+        };
+
+        while (query.next()) {
+            const QString tableName = query.value(0).toString();
+            if (!table || table->name != tableName) {
+                addPrimaryKey(table);
+                table = schema.table(tableName);
+            }
+            ColumnPrivate *c = schema.addColumn(table, query.value(1).toString(), ColumnPrivate::Invalid);
+            schema.setTypeFromName(c, query.value(2).toString());
+            c->_nullable = query.value(3).toInt() == 0;
+            c->defVal = Schema::defaultFromExpression(query.value(4).toString());
+            const int pk = query.value(5).toInt();
+            if (pk > 0) {
+                pkCols.emplace_back(pk, c->name);
+            }
+        }
+        addPrimaryKey(table);
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT m.name, il.name, il.\"unique\", il.origin, ii.name "
+                                               "FROM sqlite_master AS m JOIN pragma_index_list(m.name) AS il JOIN pragma_index_info(il.name) AS ii "
+                                               "WHERE m.type = 'table' AND substr(m.name, 1, 7) <> 'sqlite_' AND il.origin <> 'pk' "
+                                               "ORDER BY m.name, il.name, ii.seqno"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            const QString indexName = query.value(1).toString();
+            const bool constraint = query.value(3).toString() == QLatin1String("u");
+            const ColumnPrivate::Type type = query.value(2).toInt() != 0 ? ColumnPrivate::UniqueKey : ColumnPrivate::Key;
+            ColumnPrivate *key = collector.key(query.value(0).toString(), indexName, type);
+            if (!key) {
+                continue;
+            }
+            // indexes created for UNIQUE constraints get generated names
+            if (!constraint) {
+                key->indexName = indexName;
+            }
+            if (!query.value(4).isNull()) {
+                key->constraintCols.append(query.value(4).toString());
+            }
+        }
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT m.name, fk.id, fk.\"from\", fk.\"table\", fk.\"to\", fk.on_update, fk.on_delete "
+                                               "FROM sqlite_master AS m JOIN pragma_foreign_key_list(m.name) AS fk "
+                                               "WHERE m.type = 'table' AND substr(m.name, 1, 7) <> 'sqlite_' "
+                                               "ORDER BY m.name, fk.id, fk.seq"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            ColumnPrivate *fk = collector.key(query.value(0).toString(), query.value(1).toString(), ColumnPrivate::ForeignKey);
+            if (!fk) {
+                continue;
+            }
+            fk->constraintCols.append(query.value(2).toString());
+            fk->referenceTable = query.value(3).toString();
+            fk->referenceCols.append(query.value(4).toString());
+            fk->onUpdate = referentialAction(query.value(5));
+            fk->onDelete = referentialAction(query.value(6));
+        }
+    }
+
+    return true;
+}
+
+bool Firfuorida::loadPsqlSchema(QSqlDatabase &db, Schema &schema, Error &error)
+{
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT table_name, obj_description(format('%I.%I', table_schema, table_name)::regclass, 'pg_class') "
+                                               "FROM information_schema.tables "
+                                               "WHERE table_schema = current_schema() AND table_type = 'BASE TABLE' "
+                                               "ORDER BY table_name"), error)) {
+        return false;
+    }
+    while (query.next()) {
+        SchemaTable *table = schema.addTable(query.value(0).toString());
+        table->comment = query.value(1).toString();
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT table_name, column_name, data_type, is_nullable, column_default, "
+                                               "character_maximum_length, numeric_precision, numeric_scale, collation_name, "
+                                               "col_description(format('%I.%I', table_schema, table_name)::regclass, ordinal_position) "
+                                               "FROM information_schema.columns "
+                                               "WHERE table_schema = current_schema() "
+                                               "ORDER BY table_name, ordinal_position"), error)) {
+        return false;
+    }
+    while (query.next()) {
+        SchemaTable *table = schema.table(query.value(0).toString());
+        if (!table) {
+            continue;
+        }
+        ColumnPrivate *c = schema.addColumn(table, query.value(1).toString(), ColumnPrivate::Invalid);
+
+        // information_schema uses the SQL standard names
+        QString dataType = query.value(2).toString();
+        if (dataType == QLatin1String("character varying")) {
+            dataType = QStringLiteral("VARCHAR");
+        } else if (dataType == QLatin1String("character")) {
+            dataType = QStringLiteral("CHAR");
+        } else if (dataType.startsWith(QLatin1String("timestamp"))) {
+            dataType = QStringLiteral("TIMESTAMP");
+        } else if (dataType.startsWith(QLatin1String("time"))) {
+            dataType = QStringLiteral("TIME");
+        }
+        schema.setTypeFromName(c, dataType);
+
+        if (!query.value(5).isNull()) {
+            c->length = query.value(5).toUInt();
+        }
+        if ((c->type == ColumnPrivate::Decimal || c->type == ColumnPrivate::Numeric) && !query.value(6).isNull()) {
+            c->precision = query.value(6).toUInt();
+            c->scale = query.value(7).toUInt();
+        }
+        c->_nullable = query.value(3).toString() == QLatin1String("YES");
+
+        const QString defVal = query.value(4).toString();
+        if (defVal.startsWith(QLatin1String("nextval("))) {
+            c->_autoIncrement = true;
+        } else {
+            c->defVal = Schema::defaultFromExpression(defVal);
+        }
+        c->collation = query.value(8).toString();
+        c->comment = query.value(9).toString();
+    }
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT t.relname, i.relname, ix.indisunique, ix.indisprimary, a.attname "
+                                               "FROM pg_index AS ix "
+                                               "JOIN pg_class AS t ON t.oid = ix.indrelid "
+                                               "JOIN pg_class AS i ON i.oid = ix.indexrelid "
+                                               "JOIN pg_namespace AS n ON n.oid = t.relnamespace "
+                                               "JOIN LATERAL unnest(ix.indkey) WITH ORDINALITY AS k(attnum, ord) ON true "
+                                               "JOIN pg_attribute AS a ON a.attrelid = t.oid AND a.attnum = k.attnum "
+                                               "WHERE n.nspname = current_schema() "
+                                               "ORDER BY t.relname, i.relname, k.ord"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            const QString indexName = query.value(1).toString();
+            ColumnPrivate::Type type = ColumnPrivate::Key;
+            if (query.value(3).toBool()) {
+                type = ColumnPrivate::PrimaryKey;
+            } else if (query.value(2).toBool()) {
+                type = ColumnPrivate::UniqueKey;
+            }
+            ColumnPrivate *key = collector.key(query.value(0).toString(), indexName, type);
+            if (!key) {
+                continue;
+            }
+            if (type == ColumnPrivate::PrimaryKey) {
+                key->name = indexName;
+            } else {
+                key->indexName = indexName;
+            }
+            key->constraintCols.append(query.value(4).toString());
+        }
+    }
+
+    inlineAutoIncrementPrimaryKeys(schema);
+
+    if (!execSchemaQuery(query, QStringLiteral("SELECT kcu.table_name, kcu.constraint_name, kcu.column_name, ccu.table_name, ccu.column_name, "
+                                               "rc.update_rule, rc.delete_rule "
+                                               "FROM information_schema.referential_constraints AS rc "
+                                               "JOIN information_schema.key_column_usage AS kcu "
+                                               "ON kcu.constraint_schema = rc.constraint_schema AND kcu.constraint_name = rc.constraint_name "
+                                               "JOIN information_schema.key_column_usage AS ccu "
+                                               "ON ccu.constraint_schema = rc.unique_constraint_schema AND ccu.constraint_name = rc.unique_constraint_name "
+                                               "AND ccu.ordinal_position = kcu.position_in_unique_constraint "
+                                               "WHERE kcu.table_schema = current_schema() "
+                                               "ORDER BY kcu.table_name, kcu.constraint_name, kcu.ordinal_position"), error)) {
+        return false;
+    }
+    {
+        KeyCollector collector(schema);
+        while (query.next()) {
+            const QString constraintName = query.value(1).toString();
+            ColumnPrivate *fk = collector.key(query.value(0).toString(), constraintName, ColumnPrivate::ForeignKey);
+            if (!fk) {
+                continue;
+            }
+            fk->name = constraintName;
+            fk->constraintCols.append(query.value(2).toString());
+            fk->referenceTable = query.value(3).toString();
+            fk->referenceCols.append(query.value(4).toString());
+            fk->onUpdate = referentialAction(query.value(5));
+            fk->onDelete = referentialAction(query.value(6));
+        }
+    }
+
+    return true;
+}
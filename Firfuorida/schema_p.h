@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_SCHEMA_P_H
+#define FIRFUORIDA_SCHEMA_P_H
+
+#include "column_p.h"
+#include "error.h"
+#include <QHash>
+#include <QSqlDatabase>
+#include <vector>
+
+namespace Firfuorida {
+
+/*!
+ * \internal
+ * \brief A table read from the live database.
+ *
+ * Columns, indexes and foreign keys are stored as ColumnPrivate objects just like
+ * the ones declared by Table, keys and foreign keys follow the data columns.
+ * The columns are not attached to a TablePrivate, so the Column setters must
+ * not be called on them.
+ */
+class SchemaTable
+{
+public:
+    /*!
+     * \brief Returns the data column, index or foreign key called \a name or \c nullptr.
+     */
+    const ColumnPrivate *column(const QString &name) const;
+    ColumnPrivate *column(const QString &name);
+
+    QString name;
+    QString engine;
+    QString collation;
+    QString comment;
+    std::vector<ColumnPrivate> columns;
+};
+
+/*!
+ * \internal
+ * \brief In-memory model of all tables in the current database schema.
+ *
+ * The model is filled by Dialect::loadSchema(). The columns point to the DbContext
+ * of the schema, so a %Schema can not be copied or moved.
+ */
+class Schema
+{
+public:
+    explicit Schema(const DbContext &context) : context(context) {}
+
+    /*!
+     * \brief Returns the table called \a name or \c nullptr.
+     */
+    const SchemaTable *table(const QString &name) const;
+    SchemaTable *table(const QString &name);
+
+    /*!
+     * \brief Returns the table called \a name, adding it if it does not exist.
+     */
+    SchemaTable *addTable(const QString &name);
+
+    /*!
+     * \brief Appends a new column of \a type to \a table.
+     */
+    ColumnPrivate *addColumn(SchemaTable *table, const QString &name, ColumnPrivate::Type type);
+
+    /*!
+     * \brief Sets type, length, precision, scale and values of \a column from the SQL \a typeName.
+     *
+     * The name is looked up in the type mapping of the dialect, so that the result
+     * renders to the same type string as a column declared with the same type.
+     * Unknown types result in ColumnPrivate::Invalid.
+     */
+    void setTypeFromName(ColumnPrivate *column, const QString &typeName) const;
+
+    /*!
+     * \brief Converts the DEFAULT expression \a expr reported by the database into a default value.
+     */
+    static QVariant defaultFromExpression(const QString &expr);
+
+    const DbContext context;
+    std::vector<SchemaTable> tables;
+
+private:
+    Q_DISABLE_COPY(Schema)
+    QHash<QString, std::size_t> m_tableIndex;
+};
+
+bool loadMySqlSchema(QSqlDatabase &db, Schema &schema, Error &error);
+bool loadSqliteSchema(QSqlDatabase &db, Schema &schema, Error &error);
+bool loadPsqlSchema(QSqlDatabase &db, Schema &schema, Error &error);
+
+}
+
+#endif // FIRFUORIDA_SCHEMA_P_H
@@ -0,0 +1,344 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "schemadiff_p.h"
+#include "schema_p.h"
+#include "table_p.h"
+#include "migrator_p.h"
+#include "sqlbuilder_p.h"
+#include <QHash>
+#include <QSet>
+#include "logging.h"
+
+using namespace Firfuorida;
+
+namespace {
+
+/*!
+ * \internal
+ * \brief A normalized column, index or foreign key of one side of the comparison.
+ *
+ * Data columns are identified by their name, indexes and foreign keys by their
+ * definition, as their names are often generated by the database.
+ */
+class Entry
+{
+public:
+    QString id;
+    QString definition;
+    const ColumnPrivate *column = nullptr;
+
+    bool isKey() const { return column->type >= ColumnPrivate::Key; }
+};
+
+/*!
+ * \internal
+ * \brief The entries of one table side and the hash over all of them.
+ */
+class Side
+{
+public:
+    void add(const QString &id, const QString &definition, const ColumnPrivate *column)
+    {
+        index.insert(id, entries.size());
+        entries.push_back(Entry{id, definition, column});
+        hash += fnv1a(id) ^ (fnv1a(definition) * 31);
+    }
+
+    const Entry *find(const QString &id) const
+    {
+        const auto it = index.constFind(id);
+        return it != index.constEnd() ? &entries[it.value()] : nullptr;
+    }
+
+    std::vector<Entry> entries;
+    QHash<QString, std::size_t> index;
+    // order independent, so that the column order does not matter
+    quint64 hash = 0;
+
+private:
+    static quint64 fnv1a(const QString &str)
+    {
+        quint64 h = Q_UINT64_C(14695981039346656037);
+        for (const QChar c : str) {
+            h ^= c.unicode();
+            h *= Q_UINT64_C(1099511628211);
+        }
+        return h;
+    }
+};
+
+bool isRenderable(const ColumnPrivate &col)
+{
+    if (col.type == ColumnPrivate::Invalid) {
+        return false;
+    }
+    const TypeMapping *mappings = col.context->dialect->typeMappings();
+    return mappings && mappings[col.type].name;
+}
+
+/*!
+ * \internal
+ * \brief Returns the columns of \a key with their prefix lengths.
+ *
+ * The sort order is left out, as older MySQL and MariaDB versions ignore it and
+ * report every index column as ascending.
+ */
+QString indexColumns(const ColumnPrivate &key)
+{
+    QString cols;
+    for (int i = 0; i < key.constraintCols.size(); ++i) {
+        if (i > 0) {
+            cols += QLatin1Char(',');
+        }
+        cols += key.constraintCols.at(i);
+        if (static_cast<std::size_t>(i) < key.indexParts.size() && key.indexParts[static_cast<std::size_t>(i)].length > 0) {
+            cols += QLatin1Char('(') % QString::number(key.indexParts[static_cast<std::size_t>(i)].length) % QLatin1Char(')');
+        }
+    }
+    return cols;
+}
+
+QString keyId(const ColumnPrivate &key)
+{
+    return QLatin1String("k:") % QString::number(key.type) % QLatin1Char('|') % indexColumns(key)
+            % QLatin1Char('|') % key.referenceTable % QLatin1Char('|') % key.referenceCols.join(QLatin1Char(','))
+            % QLatin1Char('|') % key.onDelete.toUpper() % QLatin1Char('|') % key.onUpdate.toUpper();
+}
+
+/*!
+ * \internal
+ * \brief Returns the comparable definition of the data column \a col.
+ *
+ * Only attributes that are declared by Column and reported back by the database
+ * are part of it. Charset and collation are left out, as the database reports
+ * its defaults for columns that did not declare them.
+ */
+QString columnDefinition(const ColumnPrivate &col, bool unique, bool primary)
+{
+    const bool unsignedInt = col._unsigned && col.type < ColumnPrivate::Bit && col.isDbFeatureAvailable(Migrator::UnsignedInteger);
+    const bool nullable = col._nullable && !primary && !col._autoIncrement;
+    return col.typeString()
+            % (unsignedInt ? QLatin1String("|unsigned") : QLatin1String("|"))
+            % (nullable ? QLatin1String("|null") : QLatin1String("|"))
+            % (col._autoIncrement ? QLatin1String("|auto") : QLatin1String("|"))
+            % (unique ? QLatin1String("|unique") : QLatin1String("|"))
+            % (primary ? QLatin1String("|primary") : QLatin1String("|"))
+            % QLatin1Char('|') % (col.defVal.isNull() ? QString() : col.defValString())
+            % QLatin1Char('|') % (col.isDbFeatureAvailable(Migrator::CommentsOnColumns) ? col.comment : QString());
+}
+
+Side declaredSide(const TablePrivate &table)
+{
+    Side side;
+    for (const auto &chunk : table.columns) {
+        for (const ColumnPrivate &col : chunk) {
+            if (!isRenderable(col)) {
+                continue;
+            }
+            if (col.type < ColumnPrivate::Key) {
+                side.add(QLatin1String("c:") % col.name, columnDefinition(col, col._unique, col._primaryKey), &col);
+            } else {
+                const QString id = keyId(col);
+                side.add(id, id, &col);
+            }
+        }
+    }
+    return side;
+}
+
+/*!
+ * \internal
+ * \brief Returns the entries of the \a live table normalized towards the \a declared side.
+ *
+ * Single column primary and unique keys are folded into the column if the declared
+ * column has them inline, display widths the declaration does not care about are
+ * ignored and indexes the database created implicitly for foreign keys are skipped.
+ */
+Side liveSide(const SchemaTable &live, const Side &declared)
+{
+    auto declaredColumn = [&declared](const QString &name) -> const ColumnPrivate * {
+        const Entry *e = declared.find(QLatin1String("c:") % name);
+        return e ? e->column : nullptr;
+    };
+
+    QSet<QString> uniqueCols;
+    QSet<QString> primaryCols;
+    QSet<QString> foreignKeyCols;
+    for (const ColumnPrivate &col : live.columns) {
+        if (col.type == ColumnPrivate::ForeignKey) {
+            foreignKeyCols.insert(col.constraintCols.join(QLatin1Char(',')));
+        }
+        if (col.constraintCols.size() != 1) {
+            continue;
+        }
+        const ColumnPrivate *dc = declaredColumn(col.constraintCols.first());
+        if (col.type == ColumnPrivate::UniqueKey && dc && dc->_unique) {
+            uniqueCols.insert(col.constraintCols.first());
+        } else if (col.type == ColumnPrivate::PrimaryKey && dc && dc->_primaryKey) {
+            primaryCols.insert(col.constraintCols.first());
+        }
+    }
+
+    Side side;
+    for (const ColumnPrivate &col : live.columns) {
+        if (!isRenderable(col)) {
+            continue;
+        }
+        if (col.type < ColumnPrivate::Key) {
+            const bool unique = uniqueCols.contains(col.name);
+            const bool primary = primaryCols.contains(col.name);
+            const ColumnPrivate *dc = declaredColumn(col.name);
+            if (dc && dc->displayWidth == 0 && col.displayWidth != 0) {
+                ColumnPrivate normalized = col;
+                normalized.displayWidth = 0;
+                side.add(QLatin1String("c:") % col.name, columnDefinition(normalized, unique, primary), &col);
+            } else {
+                side.add(QLatin1String("c:") % col.name, columnDefinition(col, unique, primary), &col);
+            }
+        } else {
+            if (col.constraintCols.size() == 1) {
+                const QString single = col.constraintCols.first();
+                if ((col.type == ColumnPrivate::UniqueKey && uniqueCols.contains(single)) || (col.type == ColumnPrivate::PrimaryKey && primaryCols.contains(single))) {
+                    continue;
+                }
+            }
+            const QString id = keyId(col);
+            if (col.type == ColumnPrivate::Key && !declared.find(id) && foreignKeyCols.contains(col.constraintCols.join(QLatin1Char(',')))) {
+                continue;
+            }
+            side.add(id, id, &col);
+        }
+    }
+    return side;
+}
+
+void addChange(TableDiff &diff, const ColumnPrivate &col, ColumnPrivate::ColumnOperation operation)
+{
+    diff.changes.push_back(col);
+    diff.changes.back().operation = operation;
+}
+
+}
+
+std::vector<TableDiff> SchemaDiff::compare(const std::vector<const TablePrivate *> &declared, const Schema &schema)
+{
+    std::vector<TableDiff> diffs;
+
+    for (const TablePrivate *table : declared) {
+        TableDiff diff;
+        diff.name = table->q_func()->objectName();
+
+        const SchemaTable *live = schema.table(diff.name);
+        if (!live) {
+            diff.create = true;
+            diff.engine = table->engine;
+            diff.charset = table->charset;
+            diff.collation = table->collation;
+            diff.comment = table->comment;
+            diff.temporary = table->temporary;
+            for (const auto &chunk : table->columns) {
+                for (const ColumnPrivate &col : chunk) {
+                    addChange(diff, col, ColumnPrivate::CreateColumn);
+                }
+            }
+            qCDebug(FIR_CORE, "Table \"%s\" does not exist.", qUtf8Printable(diff.name));
+            diffs.push_back(std::move(diff));
+            continue;
+        }
+
+        const Side want = declaredSide(*table);
+        const Side have = liveSide(*live, want);
+        if (want.hash == have.hash && want.entries.size() == have.entries.size()) {
+            continue;
+        }
+
+        // drop first, so that added indexes do not collide with the ones they replace
+        for (const Entry &e : have.entries) {
+            if (e.isKey() && !want.find(e.id)) {
+                addChange(diff, *e.column, ColumnPrivate::DropColumn);
+            }
+        }
+        for (const Entry &e : have.entries) {
+            if (!e.isKey() && !want.find(e.id)) {
+                addChange(diff, *e.column, ColumnPrivate::DropColumn);
+            }
+        }
+        for (const Entry &e : want.entries) {
+            if (e.isKey()) {
+                continue;
+            }
+            const Entry *h = have.find(e.id);
+            if (!h) {
+                addChange(diff, *e.column, ColumnPrivate::AddColumn);
+            } else if (h->definition != e.definition) {
+                addChange(diff, *e.column, ColumnPrivate::ModifyColumn);
+            }
+        }
+        for (const Entry &e : want.entries) {
+            if (e.isKey() && !have.find(e.id)) {
+                addChange(diff, *e.column, ColumnPrivate::AddColumn);
+            }
+        }
+
+        if (!diff.changes.empty()) {
+            qCDebug(FIR_CORE, "Table \"%s\" differs in %i columns and indexes.", qUtf8Printable(diff.name), static_cast<int>(diff.changes.size()));
+            diffs.push_back(std::move(diff));
+        }
+    }
+
+    return diffs;
+}
+
+DiffMigration::DiffMigration(Migrator *parent, std::vector<TableDiff> &&diffs) :
+    Migration(parent), m_diffs(std::move(diffs))
+{
+
+}
+
+void DiffMigration::up()
+{
+    const Dialect *dialect = MigratorPrivate::get(qobject_cast<Migrator*>(parent()))->context.dialect;
+
+    for (const TableDiff &diff : m_diffs) {
+        if (diff.create) {
+            Table *t = create(diff.name);
+            TablePrivate *td = TablePrivate::get(t);
+            td->engine = diff.engine;
+            td->charset = diff.charset;
+            td->collation = diff.collation;
+            td->comment = diff.comment;
+            td->temporary = diff.temporary;
+            for (const ColumnPrivate &change : diff.changes) {
+                addChange(t, change);
+            }
+        } else {
+            Table *t = dialect->supportsMultipleAlterClauses() ? table(diff.name) : nullptr;
+            for (const ColumnPrivate &change : diff.changes) {
+                if (dialect->altersIndexesSeparately() && (change.type == ColumnPrivate::Key || change.type == ColumnPrivate::UniqueKey)) {
+                    SqlBuilder sql(dialect);
+                    if (change.operation == ColumnPrivate::DropColumn) {
+                        dialect->renderDropIndex(sql, change);
+                    } else {
+                        dialect->renderCreateIndex(sql, diff.name, change);
+                    }
+                    raw(sql.take());
+                } else {
+                    addChange(t ? t : table(diff.name), change);
+                }
+            }
+        }
+    }
+}
+
+void DiffMigration::addChange(Table *table, const ColumnPrivate &change)
+{
+    TablePrivate *td = TablePrivate::get(table);
+    ColumnPrivate *c = td->addColumn(change.name, change.type);
+    *c = change;
+    c->table = td;
+    c->context = &td->context;
+    c->dirty = true;
+}
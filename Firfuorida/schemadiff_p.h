@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_SCHEMADIFF_P_H
+#define FIRFUORIDA_SCHEMADIFF_P_H
+
+#include "migration.h"
+#include "column_p.h"
+#include <vector>
+
+namespace Firfuorida {
+
+class TablePrivate;
+class Schema;
+
+/*!
+ * \internal
+ * \brief The changes needed to converge a single table.
+ *
+ * The changes are copies of the declared or introspected columns whose operation
+ * has been set to what has to be done with them, so the diff stays valid after
+ * the declared tables have been destroyed.
+ */
+class TableDiff
+{
+public:
+    QString name;
+    QString engine;
+    QString charset;
+    QString collation;
+    QString comment;
+    std::vector<ColumnPrivate> changes;
+    bool create = false;
+    bool temporary = false;
+};
+
+/*!
+ * \internal
+ * \brief Compares declared tables with the live database schema.
+ */
+class SchemaDiff
+{
+public:
+    /*!
+     * \brief Returns the changes per table that turn \a schema into the \a declared tables.
+     *
+     * Every table is reduced to a hash over its normalized column, index and foreign
+     * key definitions first. Only tables whose hashes differ are compared entry by entry.
+     * Tables of the \a schema that are not declared are not touched.
+     */
+    static std::vector<TableDiff> compare(const std::vector<const TablePrivate *> &declared, const Schema &schema);
+};
+
+/*!
+ * \internal
+ * \brief Applies a list of TableDiff objects.
+ *
+ * All changes of a table are combined into a single ALTER TABLE statement if the
+ * dialect supports it, declared tables that are missing are created.
+ */
+class DiffMigration : public Migration
+{
+public:
+    DiffMigration(Migrator *parent, std::vector<TableDiff> &&diffs);
+    ~DiffMigration() override = default;
+
+protected:
+    void up() override;
+    void down() override {}
+
+private:
+    void addChange(Table *table, const ColumnPrivate &change);
+
+    std::vector<TableDiff> m_diffs;
+};
+
+}
+
+#endif // FIRFUORIDA_SCHEMADIFF_P_H
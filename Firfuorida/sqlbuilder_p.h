@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef FIRFUORIDA_SQLBUILDER_P_H
+#define FIRFUORIDA_SQLBUILDER_P_H
+
+#include "dialect_p.h"
+#include <QString>
+#include <QStringList>
+#include <utility>
+
+namespace Firfuorida {
+
+/*!
+ * \internal
+ * \brief Appends SQL fragments into a single pre-reserved buffer.
+ *
+ * Rendering code writes keywords, identifiers, numbers and string literals directly
+ * into the buffer instead of building temporary strings that are joined afterwards.
+ * Quoting and escaping follow the rules of the Dialect the builder has been
+ * created for.
+ */
+class SqlBuilder
+{
+public:
+    using size_type = QString::size_type;
+
+    explicit SqlBuilder(const Dialect *dialect, size_type reserve = 256) : m_dialect(dialect)
+    {
+        m_sql.reserve(reserve);
+    }
+
+    const Dialect *dialect() const { return m_dialect; }
+
+    SqlBuilder &operator<<(QLatin1String str) { m_sql.append(str); return *this; }
+    SqlBuilder &operator<<(const QString &str) { m_sql.append(str); return *this; }
+    SqlBuilder &operator<<(QLatin1Char c) { m_sql.append(c); return *this; }
+    SqlBuilder &operator<<(QChar c) { m_sql.append(c); return *this; }
+
+    /*!
+     * \brief Appends the decimal representation of \a number without a temporary string.
+     */
+    SqlBuilder &number(qulonglong number)
+    {
+        char buf[24];
+        int pos = sizeof(buf);
+        do {
+            buf[--pos] = static_cast<char>('0' + (number % 10));
+            number /= 10;
+        } while (number > 0);
+        m_sql.append(QLatin1String(buf + pos, static_cast<int>(sizeof(buf)) - pos));
+        return *this;
+    }
+
+    /*!
+     * \brief Marks the current end of the buffer as the start of a space separated fragment.
+     */
+    void startFragment() { m_fragmentStart = m_sql.size(); }
+
+    /*!
+     * \brief Appends a single space if something has been written since startFragment().
+     */
+    SqlBuilder &separate()
+    {
+        if (m_sql.size() > m_fragmentStart) {
+            m_sql.append(QLatin1Char(' '));
+        }
+        return *this;
+    }
+
+    /*!
+     * \brief Appends \a str separated by a space from the previous word of the current fragment.
+     */
+    template<typename T>
+    SqlBuilder &word(const T &str)
+    {
+        separate();
+        return *this << str;
+    }
+
+    /*!
+     * \brief Appends the identifier \a name.
+     *
+     * Plain identifiers and qualified names are written as they are, so that the
+     * database applies its usual case folding. Everything else is quoted with the
+     * identifier quote of the dialect.
+     */
+    SqlBuilder &identifier(const QString &name)
+    {
+        if (isPlainIdentifier(name)) {
+            m_sql.append(name);
+            return *this;
+        }
+
+        const QChar quote = m_dialect->identifierQuote();
+        m_sql.append(quote);
+        for (const QChar c : name) {
+            if (c == quote) {
+                m_sql.append(quote);
+            }
+            m_sql.append(c);
+        }
+        m_sql.append(quote);
+        return *this;
+    }
+
+    /*!
+     * \brief Appends \a list enclosed in parentheses and separated by \a separator.
+     */
+    SqlBuilder &list(const QStringList &list, QLatin1String separator = QLatin1String(","))
+    {
+        m_sql.append(QLatin1Char('('));
+        bool first = true;
+        for (const QString &part : list) {
+            if (!first) {
+                m_sql.append(separator);
+            }
+            m_sql.append(part);
+            first = false;
+        }
+        m_sql.append(QLatin1Char(')'));
+        return *this;
+    }
+
+    /*!
+     * \brief Appends \a str as single quoted string literal.
+     *
+     * Dialects with backslash escapes escape quotes and backslashes by a backslash,
+     * the others use standard SQL escaping by doubling the single quote.
+     */
+    SqlBuilder &stringLiteral(const QString &str)
+    {
+        const bool backslashEscapes = m_dialect->backslashEscapes();
+        m_sql.append(QLatin1Char('\''));
+        for (const QChar c : str) {
+            if (c == QLatin1Char('\'')) {
+                m_sql.append(backslashEscapes ? QLatin1Char('\\') : QLatin1Char('\''));
+            } else if (backslashEscapes && c == QLatin1Char('\\')) {
+                m_sql.append(QLatin1Char('\\'));
+            }
+            m_sql.append(c);
+        }
+        m_sql.append(QLatin1Char('\''));
+        return *this;
+    }
+
+    size_type size() const { return m_sql.size(); }
+
+    bool isEmpty() const { return m_sql.isEmpty(); }
+
+    /*!
+     * \brief Removes everything behind \a pos, used to roll back fragments that turned out empty.
+     */
+    void truncate(size_type pos) { m_sql.truncate(pos); }
+
+    QString mid(size_type pos) const { return m_sql.mid(pos); }
+
+    /*!
+     * \brief Returns the rendered SQL and leaves the builder empty.
+     */
+    QString take() { return std::move(m_sql); }
+
+private:
+    static bool isPlainIdentifier(const QString &name)
+    {
+        if (name.isEmpty() || name.at(0).isDigit()) {
+            return false;
+        }
+        for (const QChar c : name) {
+            if (!(c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('.') || c == QLatin1Char('$'))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QString m_sql;
+    size_type m_fragmentStart = 0;
+    const Dialect *m_dialect;
+};
+
+}
+
+#endif // FIRFUORIDA_SQLBUILDER_P_H
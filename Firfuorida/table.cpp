@@ -5,6 +5,7 @@
 
 #include "table_p.h"
 #include "column_p.h"
+#include "sqlbuilder_p.h"
 #include <QStringList>
 #include "logging.h"
 #include "migration.h"
@@ -13,108 +14,180 @@ using namespace Firfuorida;
 
 QString TablePrivate::queryString() const
 {
-    QString qs;
+    if (operation == Raw) {
+        return raw;
+    }
+
+    if (!dirty) {
+        return renderedQuery;
+    }
 
     Q_Q(const Table);
 
+    SqlBuilder::size_type columnCount = 0;
+    for (const auto &chunk : columns) {
+        columnCount += static_cast<SqlBuilder::size_type>(chunk.size());
+    }
+    SqlBuilder sql(context.dialect, 128 + columnCount * 64);
+
     if (operation == CreateTable || operation == CreateTableIfNotExists) {
-        qs = temporary ? QStringLiteral("CREATE TEMPORARY TABLE ") : QStringLiteral("CREATE TABLE ");
+        sql << (temporary ? QLatin1String("CREATE TEMPORARY TABLE ") : QLatin1String("CREATE TABLE "));
 
         if (operation == CreateTableIfNotExists) {
-            qs += QStringLiteral("IF NOT EXISTS ");
+            sql << QLatin1String("IF NOT EXISTS ");
         }
 
-        qs += q->objectName() + QLatin1Char('(');
+        sql.identifier(q->objectName()) << QLatin1Char('(');
+        renderColumns(sql);
+        sql << QLatin1Char(')');
 
-        const QList<Column *> cols = q->findChildren<Column *>(QString(), Qt::FindDirectChildrenOnly);
-        QStringList colParts;
-        for (Column *col : cols) {
-            const QString qs = col->d_func()->queryString();
-            if (!qs.isEmpty()) {
-                colParts << qs;
-            }
-        }
-        qs += colParts.join(QStringLiteral(", "));
-
-        qs += QLatin1Char(')');
         if (!engine.isEmpty()) {
-            qs += QStringLiteral(" ENGINE = ") + engine;
+            sql << QLatin1String(" ENGINE = ") << engine;
         }
         if (!charset.isEmpty()) {
-            qs += QStringLiteral(" DEFAULT CHARSET = ") + charset;
+            sql << QLatin1String(" DEFAULT CHARSET = ") << charset;
         }
         if (!collation.isEmpty()) {
-            qs += QStringLiteral(" COLLATE = ") + collation;
+            sql << QLatin1String(" COLLATE = ") << collation;
         }
         if (!comment.isEmpty()) {
-            qs += QStringLiteral(" COMMENT = \"") + comment + QStringLiteral("\"");
+            sql << QLatin1String(" COMMENT = ");
+            sql.stringLiteral(comment);
+        }
+        if (partitionType != NoPartitioning) {
+            sql << QLatin1Char(' ');
+            context.dialect->renderPartitionBy(sql, *this);
         }
     } else if (operation == DropTable) {
-        qs = QStringLiteral("DROP TABLE ") + q->objectName();
+        sql << QLatin1String("DROP TABLE ");
+        sql.identifier(q->objectName());
     } else if (operation == DropTableIfExists) {
-        qs = QStringLiteral("DROP TABLE IF EXISTS ") + q->objectName();
+        sql << QLatin1String("DROP TABLE IF EXISTS ");
+        sql.identifier(q->objectName());
     } else if (operation == ModifyTable) {
-        qs = QStringLiteral("ALTER TABLE ") + q->objectName() + QChar(QChar::Space);
-        const QList<Column*> cols = q->findChildren<Column*>(QString(), Qt::FindDirectChildrenOnly);
-        QStringList colParts;
-        for (Column *col : cols) {
-            const QString qs = col->d_func()->queryString();
-            if (!qs.isEmpty()) {
-                colParts << qs;
+        sql << QLatin1String("ALTER TABLE ");
+        sql.identifier(q->objectName()) << QLatin1Char(' ');
+        const SqlBuilder::size_type columnsStart = sql.size();
+        renderColumns(sql);
+        if (partitionType != NoPartitioning) {
+            if (sql.size() > columnsStart) {
+                sql << QLatin1Char(' ');
             }
+            context.dialect->renderPartitionBy(sql, *this);
+        }
+        // nothing the database supports has been changed
+        if (sql.size() == columnsStart) {
+            sql.truncate(0);
         }
-        qs += colParts.join(QLatin1String(", "));
-    } else if (operation == Raw) {
-        qs = raw;
+    } else if (operation == PartitionTable) {
+        context.dialect->renderPartitionOperation(sql, *this);
     }
 
-    return qs;
+    renderedQuery = sql.take();
+    dirty = false;
+    return renderedQuery;
 }
 
-Migrator::DatabaseType TablePrivate::dbType() const
+void TablePrivate::renderColumns(SqlBuilder &sql) const
 {
-    Q_Q(const Table);
-    auto migration = qobject_cast<Migration*>(q->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbType();
+    bool first = true;
+    for (const auto &chunk : columns) {
+        for (const ColumnPrivate &col : chunk) {
+            const SqlBuilder::size_type mark = sql.size();
+            if (!first) {
+                sql << QLatin1String(", ");
+            }
+            const SqlBuilder::size_type colStart = sql.size();
+            col.renderQuery(sql);
+            if (sql.size() == colStart) {
+                sql.truncate(mark);
+            } else {
+                first = false;
+            }
+        }
+    }
 }
 
-QString TablePrivate::dbTypeToStr() const
+ColumnPrivate *TablePrivate::addColumn(const QString &name, ColumnPrivate::Type type)
 {
-    Q_Q(const Table);
-    auto migration = qobject_cast<Migration*>(q->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbTypeToStr();
-}
+    if (columns.empty() || columns.back().size() == columns.back().capacity()) {
+        columns.emplace_back();
+        columns.back().reserve(ColumnChunkSize);
+    }
+    columns.back().emplace_back();
 
-QVersionNumber TablePrivate::dbVersion() const
-{
-    Q_Q(const Table);
-    auto migration = qobject_cast<Migration*>(q->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbVersion();
+    ColumnPrivate *c = &columns.back().back();
+    c->name = name;
+    c->type = type;
+    c->operation = (operation == CreateTable || operation == CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
+    c->table = this;
+    c->context = &context;
+    dirty = true;
+    return c;
 }
 
-Migrator::DatabaseFeatures TablePrivate::dbFeatures() const
+void TablePrivate::addPartition(PartitionPrivate &&partition)
 {
-    Q_Q(const Table);
-    auto migration = qobject_cast<Migration*>(q->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->dbFeatures();
+    Q_Q(Table);
+
+    if (!isDbFeatureAvailable(Migrator::Partitioning)) {
+        qCWarning(FIR_CORE, "%s %s does not support partitioning tables. Can not change partition \"%s\" of \"%s\".", qUtf8Printable(dbTypeToStr()), qUtf8Printable(dbVersion().toString()), qUtf8Printable(partition.name), qUtf8Printable(q->objectName()));
+        return;
+    }
+
+    if (partition.operation == PartitionPrivate::AddPartition && partitionType != NoPartitioning && context.dialect->definesPartitionsInline()) {
+        dirty = true;
+        partitions.push_back(std::move(partition));
+        return;
+    }
+
+    auto t = new Table(qobject_cast<Migration*>(q->parent()));
+    t->setObjectName(q->objectName());
+    TablePrivate *td = t->d_func();
+    td->operation = PartitionTable;
+    td->partitionType = partitionType;
+    td->partitionKey = partitionKey;
+    td->partitions.push_back(std::move(partition));
 }
 
-bool TablePrivate::isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const
+void TablePrivate::setPartitioning(PartitionType type, const QStringList &key, uint count)
 {
-    Q_Q(const Table);
-    auto migration = qobject_cast<Migration*>(q->parent());
-    auto migrator = qobject_cast<Migrator*>(migration->parent());
-    return migrator->isDbFeatureAvailable(dbFeatures);
+    Q_Q(Table);
+
+    if (!isDbFeatureAvailable(Migrator::Partitioning)) {
+        qCWarning(FIR_CORE, "%s %s does not support partitioning tables. Can not partition \"%s\".", qUtf8Printable(dbTypeToStr()), qUtf8Printable(dbVersion().toString()), qUtf8Printable(q->objectName()));
+        return;
+    }
+
+    const bool inlinePartitions = context.dialect->definesPartitionsInline();
+    if (operation != CreateTable && operation != CreateTableIfNotExists && !(operation == ModifyTable && inlinePartitions)) {
+        qCWarning(FIR_CORE, "%s %s does not support partitioning existing tables. Can not partition \"%s\".", qUtf8Printable(dbTypeToStr()), qUtf8Printable(dbVersion().toString()), qUtf8Printable(q->objectName()));
+        return;
+    }
+
+    dirty = true;
+    partitionType = type;
+    partitionKey = key;
+
+    if (inlinePartitions) {
+        partitionCount = count;
+    } else {
+        for (uint i = 0; i < count; ++i) {
+            PartitionPrivate p;
+            p.name = q->objectName() + QLatin1String("_p") + QString::number(i);
+            p.kind = PartitionPrivate::Hash;
+            p.modulus = count;
+            p.remainder = i;
+            addPartition(std::move(p));
+        }
+    }
 }
 
 Table::Table(Firfuorida::Migration *parent) : QObject(parent), dptr(new TablePrivate)
 {
     Q_D(Table);
     d->q_ptr = this;
+    d->context = MigratorPrivate::get(qobject_cast<Migrator*>(parent->parent()))->context;
 }
 
 Table::~Table()
@@ -125,7 +198,8 @@ Table::~Table()
 void Table::setEngine(const QString &engine)
 {
     Q_D(Table);
-    if (d->dbType() != Migrator::SQLite) {
+    d->dirty = true;
+    if (d->context.dialect->supportsTableOptions()) {
         d->engine = engine;
     } else {
         qCWarning(FIR_CORE, "%s %s does not support setting an ENGINE for tables. Tried to set %s as ENGINE for \"%s\".", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(engine), qUtf8Printable(objectName()));
@@ -136,7 +210,8 @@ void Table::setEngine(const QString &engine)
 void Table::setCharset(const QString &charset)
 {
     Q_D(Table);
-    if (d->dbType() != Migrator::SQLite) {
+    d->dirty = true;
+    if (d->context.dialect->supportsTableOptions()) {
         d->charset = charset;
     } else {
         qCWarning(FIR_CORE, "%s %s does not support setting an default CHARSET for tables. Tried to set %s as CHARSET for \"%s\".", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(charset), qUtf8Printable(objectName()));
@@ -147,7 +222,8 @@ void Table::setCharset(const QString &charset)
 void Table::setCollation(const QString &collation)
 {
     Q_D(Table);
-    if (d->dbType() != Migrator::SQLite) {
+    d->dirty = true;
+    if (d->context.dialect->supportsTableOptions()) {
         d->collation = collation;
     } else {
         qCWarning(FIR_CORE, "%s %s does not support setting an default COLLATION for tables. Tried to set %s as CHARSET for \"%s\".", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(collation), qUtf8Printable(objectName()));
@@ -158,9 +234,9 @@ void Table::setCollation(const QString &collation)
 void Table::setComment(const QString &comment)
 {
     Q_D(Table);
+    d->dirty = true;
     if (d->isDbFeatureAvailable(Migrator::CommentsOnTables)) {
         QString _comment = comment;
-        _comment.replace(QLatin1Char('\''), QLatin1String("\\'"));
         if (_comment.size() > 2048) {
             qCWarning(FIR_CORE, "setComment() / COMMENT can not exceed 2048 characters. Your comment is %i characters long. It will be truncated.", _comment.size());
             _comment = _comment.left(2048);
@@ -175,239 +251,183 @@ void Table::setComment(const QString &comment)
 void Table::setIsTemporary(bool isTemporary)
 {
     Q_D(Table);
+    d->dirty = true;
     d->temporary = isTemporary;
 }
 
 Column* Table::tinyIncrements(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "tiny increments column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::TinyInt;
-    c->d_func()->_autoIncrement = true;
-    c->d_func()->_unsigned = true;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::TinyInt);
+    c->_autoIncrement = true;
+    c->_unsigned = true;
     return c;
 }
 
 Column* Table::tinyInteger(const QString &columnName, uint displayWidth)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "tiny integer column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::TinyInt;
-    c->d_func()->displayWidth = displayWidth;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::TinyInt);
+    c->displayWidth = displayWidth;
     return c;
 }
 
 Column* Table::smallIncrements(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "small increments column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::SmallInt;
-    c->d_func()->_autoIncrement = true;
-    c->d_func()->_unsigned = true;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::SmallInt);
+    c->_autoIncrement = true;
+    c->_unsigned = true;
     return c;
 }
 
 Column* Table::smallInteger(const QString &columnName, uint displayWidth)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "small integer column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::SmallInt;
-    c->d_func()->displayWidth = displayWidth;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::SmallInt);
+    c->displayWidth = displayWidth;
     return c;
 }
 
 Column* Table::mediumIncrements(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "medium increments column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::MediumInt;
-    c->d_func()->_autoIncrement = true;
-    c->d_func()->_unsigned = true;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::MediumInt);
+    c->_autoIncrement = true;
+    c->_unsigned = true;
     return c;
 }
 
 Column* Table::mediumInteger(const QString &columnName, uint displayWidth)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "medium integer column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::MediumInt;
-    c->d_func()->displayWidth = displayWidth;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::MediumInt);
+    c->displayWidth = displayWidth;
     return c;
 }
 
 Column* Table::increments(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "increments column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Int;
-    c->d_func()->_autoIncrement = true;
-    c->d_func()->_unsigned = true;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Int);
+    c->_autoIncrement = true;
+    c->_unsigned = true;
     return c;
 }
 
 Column* Table::integer(const QString &columnName, uint displayWidth)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "integer column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Int;
-    c->d_func()->displayWidth = displayWidth;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Int);
+    c->displayWidth = displayWidth;
     return c;
 }
 
 Column* Table::bigIncrements(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "big increments column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::BigInt;
-    c->d_func()->_autoIncrement = true;
-    c->d_func()->_unsigned = true;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::BigInt);
+    c->_autoIncrement = true;
+    c->_unsigned = true;
     return c;
 }
 
 Column* Table::bigInteger(const QString &columnName, uint displayWidth)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "big integer column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::BigInt;
-    c->d_func()->displayWidth = displayWidth;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::BigInt);
+    c->displayWidth = displayWidth;
     return c;
 }
 
 Column* Table::decimal(const QString &columnName, uint precision, uint scale)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "decimal column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Decimal;
-    c->d_func()->precision = precision;
-    c->d_func()->scale = scale;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Decimal);
+    c->precision = precision;
+    c->scale = scale;
     return c;
 }
 
 Column* Table::numeric(const QString &columnName, uint precision, uint scale)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "numeric column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Numeric;
-    c->d_func()->precision = precision;
-    c->d_func()->scale = scale;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Numeric);
+    c->precision = precision;
+    c->scale = scale;
     return c;
 }
 
 Column* Table::floatCol(const QString &columnName, uint precision, uint scale)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "float column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Float;
-    c->d_func()->precision = precision;
-    c->d_func()->scale = scale;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Float);
+    c->precision = precision;
+    c->scale = scale;
     return c;
 }
 
 Column* Table::doubleCol(const QString &columnName, uint precision, uint scale)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "double column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Double;
-    c->d_func()->precision = precision;
-    c->d_func()->scale = scale;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Double);
+    c->precision = precision;
+    c->scale = scale;
     return c;
 }
 
 Column* Table::bit(const QString &columnName, uint length)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "bit column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Bit;
-    c->d_func()->length = length;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Bit);
+    c->length = length;
     return c;
 }
 
 Column* Table::date(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "date column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Date;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Date);
     return c;
 }
 
 Column* Table::dateTime(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "datetime column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::DateTime;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::DateTime);
     return c;
 }
 
 Column* Table::timestamp(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "timestamp column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Timestamp;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Timestamp);
     return c;
 }
 
 Column* Table::time(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "time column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Time;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Time);
     return c;
 }
 
@@ -416,11 +436,7 @@ Column* Table::year(const QString &columnName)
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "year column", "column name can not be empty");
     Q_D(Table);
     if (d->isDbFeatureAvailable(Migrator::YearType)) {
-        auto c = new Column(this);
-        c->setObjectName(columnName.trimmed());
-        c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-        c->d_func()->type = ColumnPrivate::Year;
-        return c;
+        return d->addColumn(columnName.trimmed(), ColumnPrivate::Year);
     } else {
         qCWarning(FIR_CORE, "%s %s does not support the YEAR data type. Falling back to INTEGER data type.", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()));
         return integer(columnName);
@@ -429,137 +445,101 @@ Column* Table::year(const QString &columnName)
 
 Column *Table::binary(const QString &columnName, uint length)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "binary column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Binary;
-    c->d_func()->length = length;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Binary);
+    c->length = length;
     return c;
 }
 
 Column *Table::varBinary(const QString &columnName, uint length)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "varbinary column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::VarBinary;
-    c->d_func()->length = length;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::VarBinary);
+    c->length = length;
     return c;
 }
 
 Column* Table::tinyBlob(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "tinyblob column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::TinyBlob;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::TinyBlob);
     return c;
 }
 
 Column* Table::blob(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "blob column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Blob;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Blob);
     return c;
 }
 
 Column* Table::mediumBlob(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "medium blob column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::MediumBlob;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::MediumBlob);
     return c;
 }
 
 Column* Table::longBlob(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "long blob column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::LongBlob;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::LongBlob);
     return c;
 }
 
 Column *Table::charCol(const QString &columnName, uint length)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "char column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Char;
-    c->d_func()->length = length;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Char);
+    c->length = length;
     return c;
 }
 
 Column *Table::varChar(const QString &columnName, uint length)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "varchar column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::VarChar;
-    c->d_func()->length = length;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::VarChar);
+    c->length = length;
     return c;
 }
 
 Column* Table::tinyText(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "tinytext column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::TinyText;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::TinyText);
     return c;
 }
 
 Column* Table::text(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "text column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Text;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Text);
     return c;
 }
 
 Column* Table::mediumText(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "medium text column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::MediumText;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::MediumText);
     return c;
 }
 
 Column* Table::longText(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "long text column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::LongText;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::LongText);
     return c;
 }
 
@@ -568,11 +548,7 @@ Column* Table::json(const QString &columnName)
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "json column", "column name can not be empty");
     Q_D(Table);
     if (d->isDbFeatureAvailable(Migrator::JSONTypes)) {
-        auto c = new Column(this);
-        c->setObjectName(columnName.trimmed());
-        c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-        c->d_func()->type = ColumnPrivate::Json;
-        return c;
+        return d->addColumn(columnName.trimmed(), ColumnPrivate::Json);
     } else {
         qCWarning(FIR_CORE, "%s %s does not support the JSON data type. Falling back to LONGTEXT data type.", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()));
         return longText(columnName);
@@ -581,14 +557,12 @@ Column* Table::json(const QString &columnName)
 
 Column* Table::enumCol(const QString &columnName, const QStringList &enums)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "enum column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Invalid);
     if (d->isDbFeatureAvailable(Migrator::EnumType)) {
-        c->d_func()->type = ColumnPrivate::Enum;
-        c->d_func()->enumSet = enums;
+        c->type = ColumnPrivate::Enum;
+        c->enumSet = enums;
     } else {
         qCWarning(FIR_CORE, "%s %s does not support the ENUM data type. Omitting column \"%s\".", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(objectName()));
     }
@@ -597,14 +571,12 @@ Column* Table::enumCol(const QString &columnName, const QStringList &enums)
 
 Column* Table::set(const QString &columnName, const QStringList &setList)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "set column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Invalid);
     if (d->isDbFeatureAvailable(Migrator::SetType)) {
-        c->d_func()->type = ColumnPrivate::Set;
-        c->d_func()->enumSet = setList;
+        c->type = ColumnPrivate::Set;
+        c->enumSet = setList;
     } else {
         qCWarning(FIR_CORE, "%s %s does not support the SET data type. Omitting column \"%s\".", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(objectName()));
     }
@@ -613,23 +585,17 @@ Column* Table::set(const QString &columnName, const QStringList &setList)
 
 Column* Table::boolean(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "boolean column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Boolean;
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Boolean);
     return c;
 }
 
 Column* Table::primaryKey(const QStringList &cols, const QString &constraintSymbol)
 {
-    auto c = new Column(this);
-    c->setObjectName(constraintSymbol);
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::PrimaryKey;
-    c->d_func()->constraintCols = cols;
+    auto c = d->addColumn(constraintSymbol, ColumnPrivate::PrimaryKey);
+    c->constraintCols = cols;
     return c;
 }
 
@@ -640,12 +606,10 @@ Column* Table::primaryKey(const QString &col, const QString &constraintSymbol)
 
 Column* Table::key(const QStringList &cols, const QString &indexName)
 {
-    auto c = new Column(this);
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::Key;
-    c->d_func()->constraintCols = cols;
-    c->d_func()->indexName = indexName.trimmed();
+    auto c = d->addColumn(QString(), ColumnPrivate::Key);
+    c->constraintCols = cols;
+    c->indexName = indexName.trimmed();
     return c;
 }
 
@@ -664,15 +628,43 @@ Column* Table::index(const QString &col, const QString &indexName)
     return key(QStringList(col), indexName);
 }
 
+Column* Table::fulltextIndex(const QStringList &cols, const QString &indexName)
+{
+    Q_D(Table);
+    const TypeMapping *mappings = d->context.dialect->typeMappings();
+    if (!mappings || !mappings[ColumnPrivate::FulltextIndex].name) {
+        qCWarning(FIR_CORE, "%s %s does not support FULLTEXT indexes. The index on \"%s\" will be ignored.", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(objectName()));
+    }
+    auto c = d->addColumn(QString(), ColumnPrivate::FulltextIndex);
+    c->constraintCols = cols;
+    c->indexName = indexName.trimmed();
+    return c;
+}
+
+Column* Table::fulltextIndex(const QString &col, const QString &indexName)
+{
+    return fulltextIndex(QStringList(col), indexName);
+}
+
+Column* Table::spatialIndex(const QString &col, const QString &indexName)
+{
+    Q_D(Table);
+    const TypeMapping *mappings = d->context.dialect->typeMappings();
+    if (!mappings || !mappings[ColumnPrivate::SpatialIndex].name) {
+        qCWarning(FIR_CORE, "%s %s does not support SPATIAL indexes. The index on \"%s\" will be ignored.", qUtf8Printable(d->dbTypeToStr()), qUtf8Printable(d->dbVersion().toString()), qUtf8Printable(objectName()));
+    }
+    auto c = d->addColumn(QString(), ColumnPrivate::SpatialIndex);
+    c->constraintCols = QStringList(col);
+    c->indexName = indexName.trimmed();
+    return c;
+}
+
 Column* Table::uniqueKey(const QStringList &cols, const QString &constraintSymbol, const QString &indexName)
 {
-    auto c = new Column(this);
-    c->setObjectName(constraintSymbol);
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::UniqueKey;
-    c->d_func()->constraintCols = cols;
-    c->d_func()->indexName = indexName;
+    auto c = d->addColumn(constraintSymbol, ColumnPrivate::UniqueKey);
+    c->constraintCols = cols;
+    c->indexName = indexName;
     return c;
 }
 
@@ -693,15 +685,12 @@ Column* Table::uniqueIndex(const QString &col, const QString &constraintSymbol,
 
 Column* Table::foreignKey(const QStringList &foreignKeys, const QString &referenceTable, const QStringList &referenceCols, const QString &constraintSymbol, const QString &indexName)
 {
-    auto c = new Column(this);
-    c->setObjectName(constraintSymbol);
     Q_D(Table);
-    c->d_func()->operation = (d->operation == TablePrivate::CreateTable || d->operation == TablePrivate::CreateTableIfNotExists) ? ColumnPrivate::CreateColumn : ColumnPrivate::AddColumn;
-    c->d_func()->type = ColumnPrivate::ForeignKey;
-    c->d_func()->constraintCols = foreignKeys;
-    c->d_func()->referenceTable = referenceTable.trimmed();
-    c->d_func()->referenceCols = referenceCols;
-    c->d_func()->indexName = indexName.trimmed();
+    auto c = d->addColumn(constraintSymbol, ColumnPrivate::ForeignKey);
+    c->constraintCols = foreignKeys;
+    c->referenceTable = referenceTable.trimmed();
+    c->referenceCols = referenceCols;
+    c->indexName = indexName.trimmed();
     return c;
 }
 
@@ -712,10 +701,124 @@ Column* Table::foreignKey(const QString &foreignKeyCol, const QString &reference
 
 void Table::dropColumn(const QString &columnName)
 {
-    auto c = new Column(this);
     Q_ASSERT_X(!columnName.trimmed().isEmpty(), "drop column", "column name can not be empty");
-    c->setObjectName(columnName.trimmed());
-    c->d_func()->operation = ColumnPrivate::DropColumn;
+    Q_D(Table);
+    auto c = d->addColumn(columnName.trimmed(), ColumnPrivate::Invalid);
+    c->operation = ColumnPrivate::DropColumn;
+}
+
+void Table::partitionByRange(const QStringList &cols)
+{
+    Q_ASSERT_X(!cols.empty(), "range partitioning", "partitioning columns can not be empty");
+    Q_D(Table);
+    d->setPartitioning(TablePrivate::RangePartitioning, cols);
+}
+
+void Table::partitionByRange(const QString &col)
+{
+    partitionByRange(QStringList(col));
+}
+
+void Table::partitionByList(const QStringList &cols)
+{
+    Q_ASSERT_X(!cols.empty(), "list partitioning", "partitioning columns can not be empty");
+    Q_D(Table);
+    d->setPartitioning(TablePrivate::ListPartitioning, cols);
+}
+
+void Table::partitionByList(const QString &col)
+{
+    partitionByList(QStringList(col));
+}
+
+void Table::partitionByHash(const QString &expression, uint partitions)
+{
+    Q_ASSERT_X(!expression.trimmed().isEmpty(), "hash partitioning", "partitioning expression can not be empty");
+    Q_D(Table);
+    d->setPartitioning(TablePrivate::HashPartitioning, QStringList(expression.trimmed()), partitions);
+}
+
+void Table::partitionByKey(const QStringList &cols, uint partitions)
+{
+    Q_ASSERT_X(!cols.empty(), "key partitioning", "partitioning columns can not be empty");
+    Q_D(Table);
+    d->setPartitioning(TablePrivate::KeyPartitioning, cols, partitions);
+}
+
+void Table::rangePartition(const QString &name, const QVariant &from, const QVariant &to)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "range partition", "partition name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.kind = PartitionPrivate::Range;
+    p.from = from;
+    p.to = to;
+    d->addPartition(std::move(p));
+}
+
+void Table::listPartition(const QString &name, const QVariantList &values)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "list partition", "partition name can not be empty");
+    Q_ASSERT_X(!values.empty(), "list partition", "partition values can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.kind = PartitionPrivate::List;
+    p.values = values;
+    d->addPartition(std::move(p));
+}
+
+void Table::defaultPartition(const QString &name)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "default partition", "partition name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.kind = PartitionPrivate::Default;
+    d->addPartition(std::move(p));
+}
+
+void Table::dropPartition(const QString &name)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "drop partition", "partition name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.operation = PartitionPrivate::DropPartition;
+    d->addPartition(std::move(p));
+}
+
+void Table::detachPartition(const QString &name)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "detach partition", "partition name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.operation = PartitionPrivate::DetachPartition;
+    d->addPartition(std::move(p));
+}
+
+void Table::truncatePartition(const QString &name)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "truncate partition", "partition name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.operation = PartitionPrivate::TruncatePartition;
+    d->addPartition(std::move(p));
+}
+
+void Table::exchangePartition(const QString &name, const QString &table)
+{
+    Q_ASSERT_X(!name.trimmed().isEmpty(), "exchange partition", "partition name can not be empty");
+    Q_ASSERT_X(!table.trimmed().isEmpty(), "exchange partition", "table name can not be empty");
+    Q_D(Table);
+    PartitionPrivate p;
+    p.name = name.trimmed();
+    p.exchangeTable = table.trimmed();
+    p.operation = PartitionPrivate::ExchangePartition;
+    d->addPartition(std::move(p));
 }
 
 #include "moc_table.cpp"
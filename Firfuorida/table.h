@@ -36,6 +36,7 @@ class FIRFUORIDA_EXPORT Table : public QObject
     Q_DISABLE_COPY(Table)
     friend class Migration;
     friend class MigrationPrivate;
+    friend class TablePrivate;
     const QScopedPointer<TablePrivate> dptr;
     F_DECLARE_PRIVATE_D(dptr, Table)
     explicit Table(Migration *parent);
@@ -424,6 +425,37 @@ public:
      * \endcode
      */
     Column* index(const QString &col, const QString &indexName = QString());
+    /*!
+     * \brief Creates/modifies a fulltext index over the columns \a cols named \a indexName and returns a pointer to the Column object.
+     * The \a indexName is optional but helps to identify the index in the future.
+     * Use Column::withParser() on the returned Column object to set a parser plugin.
+     * Fulltext indexes are only supported by MySQL/MariaDB and are ignored by other databases.
+     * \par MySQL statement
+     * \code{.sql}
+     * FULLTEXT INDEX [indexName] (col1,col2)
+     * \endcode
+     */
+    Column* fulltextIndex(const QStringList &cols, const QString &indexName = QString());
+    /*!
+     * \brief Creates/modifies a fulltext index for \a col named \a indexName and returns a pointer to the Column object.
+     * The \a indexName is optional but helps to identify the index in the future.
+     * \par MySQL statement
+     * \code{.sql}
+     * FULLTEXT INDEX [indexName] (col)
+     * \endcode
+     */
+    Column* fulltextIndex(const QString &col, const QString &indexName = QString());
+    /*!
+     * \brief Creates/modifies a spatial index for the geometry column \a col named \a indexName and returns a pointer to the Column object.
+     * The \a indexName is optional but helps to identify the index in the future. The column
+     * has to be NOT NULL. Spatial indexes are only supported by MySQL/MariaDB and are ignored
+     * by other databases.
+     * \par MySQL statement
+     * \code{.sql}
+     * SPATIAL INDEX [indexName] (col)
+     * \endcode
+     */
+    Column* spatialIndex(const QString &col, const QString &indexName = QString());
     /*!
      * \brief Creates/modifies a unique key index over the columns \a cols with \a constraintSymbol named \a indexName and returns a pointer to the Column object.
      * \a constraintSymbol and \a indexName are optional but helps to identify the index in the future.
@@ -493,6 +525,179 @@ public:
      * \brief Drops the column identfied by \a columnName from the table.
      */
     void dropColumn(const QString &columnName);
+
+    /*!
+     * \brief Partitions the table by ranges of the values of the columns \a cols.
+     *
+     * Use rangePartition() to add the partitions. On MySQL/MariaDB a table can be
+     * partitioned when it is created or later by Migration::table(), on PostgreSQL
+     * only when it is created. Has no effect if the database does not support
+     * partitioning.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION BY RANGE COLUMNS (col1,col2)
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * PARTITION BY RANGE (col1,col2)
+     * \endcode
+     */
+    void partitionByRange(const QStringList &cols);
+    /*!
+     * \brief Partitions the table by ranges of the values of the column \a col.
+     * \sa partitionByRange(const QStringList &cols)
+     */
+    void partitionByRange(const QString &col);
+    /*!
+     * \brief Partitions the table by lists of values of the columns \a cols.
+     *
+     * Use listPartition() and defaultPartition() to add the partitions.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION BY LIST COLUMNS (col1,col2)
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * PARTITION BY LIST (col1,col2)
+     * \endcode
+     */
+    void partitionByList(const QStringList &cols);
+    /*!
+     * \brief Partitions the table by lists of values of the column \a col.
+     * \sa partitionByList(const QStringList &cols)
+     */
+    void partitionByList(const QString &col);
+    /*!
+     * \brief Partitions the table by the hash of \a expression into the number of \a partitions.
+     *
+     * On PostgreSQL the partitions are created as tables named after the table with
+     * a \c _p and the number of the partition appended, like \c table_p0. PostgreSQL
+     * requires expressions other than a column name to be enclosed in parentheses.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION BY HASH (expression) PARTITIONS 4
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * PARTITION BY HASH (expression)
+     * CREATE TABLE table_p0 PARTITION OF table FOR VALUES WITH (MODULUS 4, REMAINDER 0)
+     * \endcode
+     */
+    void partitionByHash(const QString &expression, uint partitions);
+    /*!
+     * \brief Partitions the table by the hash of the columns \a cols into the number of \a partitions.
+     *
+     * The hash function is chosen by the database, PostgreSQL uses HASH partitioning.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION BY KEY (col1,col2) PARTITIONS 4
+     * \endcode
+     * \sa partitionByHash()
+     */
+    void partitionByKey(const QStringList &cols, uint partitions);
+    /*!
+     * \brief Adds the range partition \a name for values from \a from inclusive up to \a to exclusive.
+     *
+     * A null \a from or \a to leaves the range unbounded. Use a QVariantList for keys over
+     * multiple columns. MySQL/MariaDB only use the upper bound, the lower one is the upper
+     * bound of the previous partition. Added to the definition of a table that is created
+     * or partitioned in the same statement on MySQL/MariaDB, added by a separate statement
+     * otherwise.
+     * \par Example
+     * \code{.cpp}
+     * auto t = create(QStringLiteral("events"));
+     * t->date(QStringLiteral("created_at"));
+     * t->partitionByRange(QStringLiteral("created_at"));
+     * t->rangePartition(QStringLiteral("events_2025"), QDate(2025,1,1), QDate(2026,1,1));
+     * t->rangePartition(QStringLiteral("events_max"), QDate(2026,1,1), QVariant());
+     * \endcode
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION events_2025 VALUES LESS THAN ('2026-01-01')
+     * ALTER TABLE events ADD PARTITION (PARTITION events_2025 VALUES LESS THAN ('2026-01-01'))
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * CREATE TABLE events_2025 PARTITION OF events FOR VALUES FROM ('2025-01-01') TO ('2026-01-01')
+     * \endcode
+     */
+    void rangePartition(const QString &name, const QVariant &from, const QVariant &to);
+    /*!
+     * \brief Adds the list partition \a name for the list of \a values.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION name VALUES IN (1, 2, 3)
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * CREATE TABLE name PARTITION OF table FOR VALUES IN (1, 2, 3)
+     * \endcode
+     */
+    void listPartition(const QString &name, const QVariantList &values);
+    /*!
+     * \brief Adds the partition \a name for all values that do not fit into another partition.
+     *
+     * On MySQL this is a range partition up to \c MAXVALUE for range partitioned tables,
+     * list partitioned tables only support a default partition on MariaDB.
+     * \par MySQL statement
+     * \code{.sql}
+     * PARTITION name DEFAULT
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * CREATE TABLE name PARTITION OF table DEFAULT
+     * \endcode
+     */
+    void defaultPartition(const QString &name);
+    /*!
+     * \brief Drops the partition \a name together with its data.
+     * \par MySQL statement
+     * \code{.sql}
+     * ALTER TABLE table DROP PARTITION name
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * DROP TABLE name
+     * \endcode
+     */
+    void dropPartition(const QString &name);
+    /*!
+     * \brief Detaches the partition \a name, so that it becomes a table of its own with the same name.
+     *
+     * Not supported by MySQL and MariaDB before 10.7.
+     * \par MariaDB statement
+     * \code{.sql}
+     * ALTER TABLE table CONVERT PARTITION name TO TABLE name
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * ALTER TABLE table DETACH PARTITION name
+     * \endcode
+     */
+    void detachPartition(const QString &name);
+    /*!
+     * \brief Removes all rows from the partition \a name.
+     * \par MySQL statement
+     * \code{.sql}
+     * ALTER TABLE table TRUNCATE PARTITION name
+     * \endcode
+     * \par PostgreSQL statement
+     * \code{.sql}
+     * TRUNCATE TABLE name
+     * \endcode
+     */
+    void truncatePartition(const QString &name);
+    /*!
+     * \brief Exchanges the partition \a name with the not partitioned table \a table.
+     *
+     * On MySQL/MariaDB the rows of both are swapped. On PostgreSQL the partition is
+     * detached and \a table is attached with the bounds of the partition instead.
+     * \par MySQL statement
+     * \code{.sql}
+     * ALTER TABLE parent EXCHANGE PARTITION name WITH TABLE table
+     * \endcode
+     */
+    void exchangePartition(const QString &name, const QString &table);
 };
 
 }
@@ -8,11 +8,53 @@
 
 #include "table.h"
 #include "migration.h"
-#include "migrator.h"
+#include "migrator_p.h"
+#include "column_p.h"
+#include <QVariant>
 #include <functional>
+#include <vector>
 
 namespace Firfuorida {
 
+class SqlBuilder;
+
+/*!
+ * \internal
+ * \brief A single partition of a partitioned table and what to do with it.
+ */
+class PartitionPrivate
+{
+public:
+    enum Kind : quint8 {
+        Range,
+        List,
+        Hash,
+        Default
+    };
+
+    enum Operation : quint8 {
+        AddPartition,
+        DropPartition,
+        DetachPartition,
+        TruncatePartition,
+        ExchangePartition
+    };
+
+    QString name;
+    // the table a partition is exchanged with
+    QString exchangeTable;
+    // lower and upper bound of a range partition, null values are unbounded
+    QVariant from;
+    QVariant to;
+    QVariantList values;
+    // the catch-all partition an added range partition is split off from
+    QString reorganize;
+    uint modulus = 0;
+    uint remainder = 0;
+    Kind kind = Range;
+    Operation operation = AddPartition;
+};
+
 class TablePrivate {
 public:
     enum TableOperation : quint8 {
@@ -24,26 +66,72 @@ public:
         RenameTable,
         Raw,
         ExecuteUpFunction,
-        ExecuteDownFunction
+        ExecuteDownFunction,
+        PartitionTable
+    };
+
+    enum PartitionType : quint8 {
+        NoPartitioning,
+        RangePartitioning,
+        ListPartitioning,
+        HashPartitioning,
+        KeyPartitioning
     };
 
+    static TablePrivate *get(Table *q) { return q->d_func(); }
+
     QString queryString() const;
+    void renderColumns(SqlBuilder &sql) const;
+
+    ColumnPrivate *addColumn(const QString &name, ColumnPrivate::Type type);
+
+    /*!
+     * \brief Adds \a partition to the partition definitions or creates a sibling table with the PartitionTable operation for it.
+     *
+     * Partitions of a table whose partitioning is declared by this table are part of
+     * its statement if the dialect defines partitions inline. Everything else needs its
+     * own statement, so that every Table still renders a single statement.
+     */
+    void addPartition(PartitionPrivate &&partition);
+
+    /*!
+     * \brief Declares the partitioning of the table by \a type over \a key.
+     *
+     * If the dialect does not define partitions inline, \a count hash partitions are
+     * added as partition tables.
+     */
+    void setPartitioning(PartitionType type, const QStringList &key, uint count = 0);
+
+    static constexpr std::size_t ColumnChunkSize = 64;
 
-    Migrator::DatabaseType dbType() const;
-    QString dbTypeToStr() const;
-    QVersionNumber dbVersion() const;
-    Migrator::DatabaseFeatures dbFeatures() const;
-    bool isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const;
+    Migrator::DatabaseType dbType() const { return context.type; }
+    QString dbTypeToStr() const { return context.typeToStr(); }
+    QVersionNumber dbVersion() const { return context.version; }
+    Migrator::DatabaseFeatures dbFeatures() const { return context.features; }
+    bool isDbFeatureAvailable(Migrator::DatabaseFeatures dbFeatures) const { return context.isFeatureAvailable(dbFeatures); }
 
+    DbContext context;
+    // columns live in fixed-capacity chunks so that returned Column pointers stay valid
+    std::vector<std::vector<ColumnPrivate>> columns;
     QString newName;
     QString engine;
     QString charset;
     QString collation;
     QString raw;
     QString comment;
+    // columns or expression of the partitioning key
+    QStringList partitionKey;
+    // the partition definitions, or the single partition operation of a PartitionTable
+    std::vector<PartitionPrivate> partitions;
+    mutable QString renderedQuery;
     Table *q_ptr = nullptr;
     TableOperation operation = CreateTable;
+    PartitionType partitionType = NoPartitioning;
+    // number of partitions created for hash and key partitioning
+    uint partitionCount = 0;
     bool temporary = false;
+    // set whenever the table or one of its columns changes, see queryString()
+    mutable bool dirty = true;
     Q_DECLARE_PUBLIC(Table)
 };
 
@@ -0,0 +1,22 @@
+# SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+# firfuorida_migration_checksums(<source>...)
+#
+# Compiles the given migration implementation files with the MD5 hash of their content,
+# that FIRFUORIDA_REGISTER_MIGRATION() registers together with the migration, so that
+# Migrator::verifyChecksums() only has to render migrations whose file changed. Only files
+# ending in .cpp are used. CMake runs again if one of the files changes, so that the
+# checksums are always up to date. Has to be called in the directory of the target
+# that compiles the files.
+function(firfuorida_migration_checksums)
+    foreach(_source ${ARGN})
+        if (NOT _source MATCHES "\\.cpp$")
+            continue()
+        endif (NOT _source MATCHES "\\.cpp$")
+        get_filename_component(_path ${_source} ABSOLUTE)
+        file(MD5 ${_path} _checksum)
+        set_property(SOURCE ${_source} APPEND PROPERTY COMPILE_DEFINITIONS FIRFUORIDA_MIGRATION_CHECKSUM="${_checksum}")
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${_path})
+    endforeach(_source ${ARGN})
+endfunction(firfuorida_migration_checksums)
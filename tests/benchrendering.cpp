@@ -0,0 +1,391 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "../Firfuorida/migrator_p.h"
+#include "../Firfuorida/migration.h"
+#include "../Firfuorida/table_p.h"
+#include <QObject>
+#include <QTest>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QVersionNumber>
+#include <atomic>
+#include <cstdlib>
+
+// Counts every heap allocation done by this process, including the ones
+// done inside the Qt libraries. Only available on glibc without sanitizers.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define FIR_BENCH_COUNT_ALLOCATIONS
+static std::atomic<quint64> s_allocations{0};
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) noexcept
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) noexcept
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) noexcept
+{
+    __libc_free(ptr);
+}
+}
+#endif
+
+#define COLUMN_COUNT 1000
+#define RENDER_ROUNDS 20
+
+using namespace Firfuorida;
+
+class BenchMigration : public Migration
+{
+    Q_OBJECT
+public:
+    explicit BenchMigration(Migrator *parent) : Migration(parent) {}
+    ~BenchMigration() override = default;
+
+    Table *createTable(const QString &tableName) { return create(tableName); }
+
+protected:
+    void up() override {}
+    void down() override {}
+};
+
+class BenchRendering : public QObject
+{
+    Q_OBJECT
+public:
+    BenchRendering(QObject *parent = nullptr) : QObject(parent) {}
+    ~BenchRendering() override = default;
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void declareColumns_data() { addData(); }
+    void declareColumns();
+
+    void renderTime_data() { addData(); }
+    void renderTime();
+
+    void renderCachedTime_data() { addData(); }
+    void renderCachedTime();
+
+    void renderAllocations_data() { addData(); }
+    void renderAllocations();
+
+private:
+    void addData();
+    Migrator *createMigrator(Migrator::DatabaseType dbType, const QVersionNumber &dbVersion);
+    Table *createTable(Migrator *migrator, const QString &column, int columnCount);
+    static void addColumn(Table *t, const QString &column, const QString &name);
+    static void invalidate(const TablePrivate *d);
+    static quint64 allocations();
+};
+
+void BenchRendering::initTestCase()
+{
+    // unsupported types per database system would flood the output with warnings
+    QLoggingCategory::setFilterRules(QStringLiteral("libfirfuorida.core.debug=false\nlibfirfuorida.core.info=false\nlibfirfuorida.core.warning=false"));
+}
+
+void BenchRendering::addData()
+{
+    QTest::addColumn<Migrator::DatabaseType>("dbType");
+    QTest::addColumn<QVersionNumber>("dbVersion");
+    QTest::addColumn<QString>("column");
+
+    const QStringList columns({
+                                  QStringLiteral("tinyInteger"),
+                                  QStringLiteral("smallInteger"),
+                                  QStringLiteral("mediumInteger"),
+                                  QStringLiteral("integer"),
+                                  QStringLiteral("bigInteger"),
+                                  QStringLiteral("increments"),
+                                  QStringLiteral("decimal"),
+                                  QStringLiteral("numeric"),
+                                  QStringLiteral("floatCol"),
+                                  QStringLiteral("doubleCol"),
+                                  QStringLiteral("bit"),
+                                  QStringLiteral("date"),
+                                  QStringLiteral("dateTime"),
+                                  QStringLiteral("timestamp"),
+                                  QStringLiteral("time"),
+                                  QStringLiteral("year"),
+                                  QStringLiteral("binary"),
+                                  QStringLiteral("varBinary"),
+                                  QStringLiteral("tinyBlob"),
+                                  QStringLiteral("blob"),
+                                  QStringLiteral("mediumBlob"),
+                                  QStringLiteral("longBlob"),
+                                  QStringLiteral("charCol"),
+                                  QStringLiteral("varChar"),
+                                  QStringLiteral("tinyText"),
+                                  QStringLiteral("text"),
+                                  QStringLiteral("mediumText"),
+                                  QStringLiteral("longText"),
+                                  QStringLiteral("json"),
+                                  QStringLiteral("enumCol"),
+                                  QStringLiteral("set"),
+                                  QStringLiteral("boolean"),
+                                  QStringLiteral("key"),
+                                  QStringLiteral("primaryKey"),
+                                  QStringLiteral("uniqueKey"),
+                                  QStringLiteral("foreignKey"),
+                                  QStringLiteral("attributes")
+                              });
+
+    const QList<QPair<Migrator::DatabaseType,QVersionNumber>> dbs({
+                                                                       qMakePair(Migrator::MySQL, QVersionNumber(8,0,30)),
+                                                                       qMakePair(Migrator::MariaDB, QVersionNumber(10,6,0)),
+                                                                       qMakePair(Migrator::PSQL, QVersionNumber(14,0)),
+                                                                       qMakePair(Migrator::SQLite, QVersionNumber(3,38,0))
+                                                                   });
+
+    for (const auto &db : dbs) {
+        const QByteArray dbName = QByteArray(QMetaEnum::fromType<Migrator::DatabaseType>().valueToKey(db.first));
+        for (const QString &column : columns) {
+            const QByteArray tag = dbName + '-' + column.toLatin1();
+            QTest::newRow(tag.constData()) << db.first << db.second << column;
+        }
+    }
+}
+
+Migrator *BenchRendering::createMigrator(Migrator::DatabaseType dbType, const QVersionNumber &dbVersion)
+{
+    auto migrator = new Migrator(QStringLiteral("benchrendering"), QStringLiteral("migrations"), this);
+    auto d = MigratorPrivate::get(migrator);
+    d->context.type = dbType;
+    d->context.version = dbVersion;
+    d->setDbFeatures();
+    return migrator;
+}
+
+Table *BenchRendering::createTable(Migrator *migrator, const QString &column, int columnCount)
+{
+    auto migration = new BenchMigration(migrator);
+    Table *t = migration->createTable(QStringLiteral("bench"));
+    for (int i = 0; i < columnCount; ++i) {
+        addColumn(t, column, column + QString::number(i));
+    }
+    return t;
+}
+
+void BenchRendering::addColumn(Table *t, const QString &column, const QString &name)
+{
+    if (column == QLatin1String("tinyInteger")) {
+        t->tinyInteger(name);
+    } else if (column == QLatin1String("smallInteger")) {
+        t->smallInteger(name);
+    } else if (column == QLatin1String("mediumInteger")) {
+        t->mediumInteger(name);
+    } else if (column == QLatin1String("integer")) {
+        t->integer(name, 11);
+    } else if (column == QLatin1String("bigInteger")) {
+        t->bigInteger(name)->unSigned();
+    } else if (column == QLatin1String("increments")) {
+        t->increments(name);
+    } else if (column == QLatin1String("decimal")) {
+        t->decimal(name, 10, 2);
+    } else if (column == QLatin1String("numeric")) {
+        t->numeric(name, 20, 4);
+    } else if (column == QLatin1String("floatCol")) {
+        t->floatCol(name, 5, 3)->defaultValue(12.34);
+    } else if (column == QLatin1String("doubleCol")) {
+        t->doubleCol(name, 20, 10);
+    } else if (column == QLatin1String("bit")) {
+        t->bit(name, 8);
+    } else if (column == QLatin1String("date")) {
+        t->date(name);
+    } else if (column == QLatin1String("dateTime")) {
+        t->dateTime(name)->defaultValue(QStringLiteral("CURRENT_TIMESTAMP"));
+    } else if (column == QLatin1String("timestamp")) {
+        t->timestamp(name)->nullable();
+    } else if (column == QLatin1String("time")) {
+        t->time(name);
+    } else if (column == QLatin1String("year")) {
+        t->year(name);
+    } else if (column == QLatin1String("binary")) {
+        t->binary(name, 16);
+    } else if (column == QLatin1String("varBinary")) {
+        t->varBinary(name, 64);
+    } else if (column == QLatin1String("tinyBlob")) {
+        t->tinyBlob(name)->nullable();
+    } else if (column == QLatin1String("blob")) {
+        t->blob(name);
+    } else if (column == QLatin1String("mediumBlob")) {
+        t->mediumBlob(name);
+    } else if (column == QLatin1String("longBlob")) {
+        t->longBlob(name);
+    } else if (column == QLatin1String("charCol")) {
+        t->charCol(name, 32);
+    } else if (column == QLatin1String("varChar")) {
+        t->varChar(name);
+    } else if (column == QLatin1String("tinyText")) {
+        t->tinyText(name);
+    } else if (column == QLatin1String("text")) {
+        t->text(name)->defaultValue(QStringLiteral("dummer schiss"));
+    } else if (column == QLatin1String("mediumText")) {
+        t->mediumText(name);
+    } else if (column == QLatin1String("longText")) {
+        t->longText(name);
+    } else if (column == QLatin1String("json")) {
+        t->json(name);
+    } else if (column == QLatin1String("enumCol")) {
+        t->enumCol(name, QStringList({QStringLiteral("one"), QStringLiteral("two"), QStringLiteral("three")}));
+    } else if (column == QLatin1String("set")) {
+        t->set(name, QStringList({QStringLiteral("one"), QStringLiteral("two"), QStringLiteral("three")}));
+    } else if (column == QLatin1String("boolean")) {
+        t->boolean(name)->defaultValue(true);
+    } else if (column == QLatin1String("key")) {
+        t->key(QStringList({QStringLiteral("col1"), QStringLiteral("col2")}), name);
+    } else if (column == QLatin1String("primaryKey")) {
+        t->primaryKey(QStringLiteral("col1"), name);
+    } else if (column == QLatin1String("uniqueKey")) {
+        t->uniqueKey(QStringLiteral("col1"), name);
+    } else if (column == QLatin1String("foreignKey")) {
+        t->foreignKey(QStringLiteral("col1"), QStringLiteral("other"), QStringLiteral("id"), name)->onDelete(QStringLiteral("CASCADE"))->onUpdate(QStringLiteral("CASCADE"));
+    } else if (column == QLatin1String("attributes")) {
+        t->varChar(name, 128)->nullable()->defaultValue(QStringLiteral("it's a default"))->collation(QStringLiteral("utf8mb4_unicode_ci"))->comment(QStringLiteral("A column with all the attributes"));
+    }
+}
+
+void BenchRendering::invalidate(const TablePrivate *d)
+{
+    d->dirty = true;
+    for (const auto &chunk : d->columns) {
+        for (const ColumnPrivate &col : chunk) {
+            col.dirty = true;
+        }
+    }
+}
+
+quint64 BenchRendering::allocations()
+{
+#ifdef FIR_BENCH_COUNT_ALLOCATIONS
+    return s_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void BenchRendering::declareColumns()
+{
+#ifndef FIR_BENCH_COUNT_ALLOCATIONS
+    QSKIP("Counting allocations is not supported on this platform.");
+#endif
+    QFETCH(Migrator::DatabaseType, dbType);
+    QFETCH(QVersionNumber, dbVersion);
+    QFETCH(QString, column);
+
+    Migrator *migrator = createMigrator(dbType, dbVersion);
+    auto migration = new BenchMigration(migrator);
+    Table *t = migration->createTable(QStringLiteral("bench"));
+
+    QStringList names;
+    names.reserve(COLUMN_COUNT);
+    for (int i = 0; i < COLUMN_COUNT; ++i) {
+        names << column + QString::number(i);
+    }
+
+    const quint64 before = allocations();
+    for (const QString &name : qAsConst(names)) {
+        addColumn(t, column, name);
+    }
+    const quint64 after = allocations();
+
+    QTest::setBenchmarkResult(static_cast<qreal>(after - before) / COLUMN_COUNT, QTest::Events);
+
+    delete migrator;
+}
+
+void BenchRendering::renderTime()
+{
+    QFETCH(Migrator::DatabaseType, dbType);
+    QFETCH(QVersionNumber, dbVersion);
+    QFETCH(QString, column);
+
+    Migrator *migrator = createMigrator(dbType, dbVersion);
+    const TablePrivate *d = TablePrivate::get(createTable(migrator, column, COLUMN_COUNT));
+
+    // warm up
+    QVERIFY(!d->queryString().isEmpty());
+
+    // the rendered SQL is cached, render it again in every round
+    qint64 elapsed = 0;
+    QElapsedTimer timer;
+    for (int i = 0; i < RENDER_ROUNDS; ++i) {
+        invalidate(d);
+        timer.start();
+        const QString qs = d->queryString();
+        elapsed += timer.nsecsElapsed();
+        Q_UNUSED(qs)
+    }
+
+    QTest::setBenchmarkResult(static_cast<qreal>(elapsed) / (RENDER_ROUNDS * COLUMN_COUNT), QTest::WalltimeNanoseconds);
+
+    delete migrator;
+}
+
+void BenchRendering::renderCachedTime()
+{
+    QFETCH(Migrator::DatabaseType, dbType);
+    QFETCH(QVersionNumber, dbVersion);
+    QFETCH(QString, column);
+
+    Migrator *migrator = createMigrator(dbType, dbVersion);
+    const TablePrivate *d = TablePrivate::get(createTable(migrator, column, COLUMN_COUNT));
+
+    QVERIFY(!d->queryString().isEmpty());
+
+    QBENCHMARK {
+        const QString qs = d->queryString();
+        Q_UNUSED(qs)
+    }
+
+    delete migrator;
+}
+
+void BenchRendering::renderAllocations()
+{
+#ifndef FIR_BENCH_COUNT_ALLOCATIONS
+    QSKIP("Counting allocations is not supported on this platform.");
+#endif
+    QFETCH(Migrator::DatabaseType, dbType);
+    QFETCH(QVersionNumber, dbVersion);
+    QFETCH(QString, column);
+
+    Migrator *migrator = createMigrator(dbType, dbVersion);
+    const TablePrivate *d = TablePrivate::get(createTable(migrator, column, COLUMN_COUNT));
+
+    const quint64 before = allocations();
+    const QString qs = d->queryString();
+    const quint64 after = allocations();
+
+    QVERIFY(!qs.isEmpty());
+    QTest::setBenchmarkResult(static_cast<qreal>(after - before) / COLUMN_COUNT, QTest::Events);
+
+    delete migrator;
+}
+
+QTEST_MAIN(BenchRendering)
+
+#include "benchrendering.moc"
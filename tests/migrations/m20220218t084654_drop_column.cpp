@@ -5,6 +5,8 @@
 
 #include "m20220218t084654_drop_column.h"
 
+FIRFUORIDA_REGISTER_MIGRATION(M20220218T084654_Drop_column)
+
 M20220218T084654_Drop_column::M20220218T084654_Drop_column(Firfuorida::Migrator *parent) :
     Firfuorida::Migration(parent)
 {
@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250301t120000_backfill.h"
+
+M20250301T120000_Backfill::M20250301T120000_Backfill(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+    setPhase(Firfuorida::Migrator::Background);
+}
+
+M20250301T120000_Backfill::~M20250301T120000_Backfill()
+{
+
+}
+
+void M20250301T120000_Backfill::up()
+{
+    raw(QStringLiteral("CREATE INDEX tiny_text_idx ON tiny (tinyTextCol)"));
+    raw(QStringLiteral("UPDATE tiny SET tinyTextCol = 'backfilled' WHERE tinyTextCol IS NULL"));
+}
+
+void M20250301T120000_Backfill::down()
+{
+    raw(QStringLiteral("DROP INDEX tiny_text_idx"));
+}
+
+#include "moc_m20250301t120000_backfill.cpp"
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250301T120000_BACKFILL_H
+#define M20250301T120000_BACKFILL_H
+
+#include <Firfuorida/migration.h>
+
+class M20250301T120000_Backfill : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250301T120000_Backfill)
+public:
+    explicit M20250301T120000_Backfill(Firfuorida::Migrator *parent);
+    ~M20250301T120000_Backfill() override;
+
+    void up() override;
+    void down() override;
+};
+
+#endif // M20250301T120000_BACKFILL_H
@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250315t090000_steps.h"
+
+M20250315T090000_Steps::M20250315T090000_Steps(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+
+}
+
+M20250315T090000_Steps::~M20250315T090000_Steps()
+{
+
+}
+
+void M20250315T090000_Steps::up()
+{
+    raw(QStringLiteral("CREATE TABLE steps1 (id INTEGER)"));
+    raw(QStringLiteral("CREATE TABLE steps2 (id INTEGER)"));
+    raw(QStringLiteral("CREATE TABLE steps3 (id INTEGER)"));
+}
+
+void M20250315T090000_Steps::down()
+{
+    raw(QStringLiteral("DROP TABLE steps3"));
+    raw(QStringLiteral("DROP TABLE steps2"));
+    raw(QStringLiteral("DROP TABLE steps1"));
+}
+
+#include "moc_m20250315t090000_steps.cpp"
@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250315T090000_STEPS_H
+#define M20250315T090000_STEPS_H
+
+#include <Firfuorida/migration.h>
+
+class M20250315T090000_Steps : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250315T090000_Steps)
+public:
+    explicit M20250315T090000_Steps(Firfuorida::Migrator *parent);
+    ~M20250315T090000_Steps() override;
+
+    void up() override;
+    void down() override;
+};
+
+#endif // M20250315T090000_STEPS_H
@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250316t090000_fixed.h"
+
+int M20250316T090000_Fixed::revision = 0;
+
+M20250316T090000_Fixed::M20250316T090000_Fixed(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+
+}
+
+M20250316T090000_Fixed::~M20250316T090000_Fixed()
+{
+
+}
+
+void M20250316T090000_Fixed::up()
+{
+    if (revision < 2) {
+        raw(QStringLiteral("CREATE TABLE fixed1 (id INTEGER)"));
+    } else {
+        raw(QStringLiteral("CREATE TABLE fixed1 (id INTEGER, name TEXT)"));
+    }
+    if (revision < 1) {
+        raw(QStringLiteral("INSERT INTO fixed_missing (id) VALUES (1)"));
+    } else {
+        raw(QStringLiteral("CREATE TABLE fixed2 (id INTEGER)"));
+    }
+    raw(QStringLiteral("CREATE TABLE fixed3 (id INTEGER)"));
+}
+
+void M20250316T090000_Fixed::down()
+{
+    raw(QStringLiteral("DROP TABLE fixed3"));
+    raw(QStringLiteral("DROP TABLE fixed2"));
+    raw(QStringLiteral("DROP TABLE fixed1"));
+}
+
+#include "moc_m20250316t090000_fixed.cpp"
@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250316T090000_FIXED_H
+#define M20250316T090000_FIXED_H
+
+#include <Firfuorida/migration.h>
+
+class M20250316T090000_Fixed : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250316T090000_Fixed)
+public:
+    explicit M20250316T090000_Fixed(Firfuorida::Migrator *parent);
+    ~M20250316T090000_Fixed() override;
+
+    void up() override;
+    void down() override;
+
+    // 0: the second statement fails, 1: the second statement is fixed, 2: the first statement is changed too
+    static int revision;
+};
+
+#endif // M20250316T090000_FIXED_H
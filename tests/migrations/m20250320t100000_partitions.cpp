@@ -0,0 +1,39 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250320t100000_partitions.h"
+#include <QDate>
+
+M20250320T100000_Partitions::M20250320T100000_Partitions(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+
+}
+
+M20250320T100000_Partitions::~M20250320T100000_Partitions()
+{
+
+}
+
+void M20250320T100000_Partitions::up()
+{
+    auto t = create(QStringLiteral("partitioned"));
+    t->integer(QStringLiteral("id"));
+    t->date(QStringLiteral("created_at"));
+    t->primaryKey(QStringList({QStringLiteral("id"), QStringLiteral("created_at")}));
+    t->partitionByRange(QStringLiteral("created_at"));
+    t->rangePartition(QStringLiteral("p2024"), QVariant(), QDate(2025, 1, 1));
+    t->rangePartition(QStringLiteral("p2025"), QDate(2025, 1, 1), QDate(2026, 1, 1));
+
+    auto t2 = table(QStringLiteral("partitioned"));
+    t2->rangePartition(QStringLiteral("pmax"), QDate(2026, 1, 1), QVariant());
+}
+
+void M20250320T100000_Partitions::down()
+{
+    drop(QStringLiteral("partitioned"));
+}
+
+#include "moc_m20250320t100000_partitions.cpp"
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250320T100000_PARTITIONS_H
+#define M20250320T100000_PARTITIONS_H
+
+#include <Firfuorida/migration.h>
+
+class M20250320T100000_Partitions : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250320T100000_Partitions)
+public:
+    explicit M20250320T100000_Partitions(Firfuorida::Migrator *parent);
+    ~M20250320T100000_Partitions() override;
+
+    void up() override;
+    void down() override;
+};
+
+#endif // M20250320T100000_PARTITIONS_H
+
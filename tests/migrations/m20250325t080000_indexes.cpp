@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250325t080000_indexes.h"
+
+M20250325T080000_Indexes::M20250325T080000_Indexes(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+
+}
+
+M20250325T080000_Indexes::~M20250325T080000_Indexes()
+{
+
+}
+
+void M20250325T080000_Indexes::up()
+{
+    auto t = create(QStringLiteral("indexed"));
+    t->increments();
+    t->varChar(QStringLiteral("title"));
+    t->text(QStringLiteral("body"));
+    t->key(QStringList({QStringLiteral("title"), QStringLiteral("id")}), QStringLiteral("title_prefix"))->prefixLength(QStringLiteral("title"), 32)->descending(QStringLiteral("id"));
+    t->fulltextIndex(QStringList({QStringLiteral("title"), QStringLiteral("body")}), QStringLiteral("title_body_fulltext"));
+}
+
+void M20250325T080000_Indexes::down()
+{
+    drop(QStringLiteral("indexed"));
+}
+
+#include "moc_m20250325t080000_indexes.cpp"
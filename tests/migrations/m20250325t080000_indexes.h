@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250325T080000_INDEXES_H
+#define M20250325T080000_INDEXES_H
+
+#include <Firfuorida/migration.h>
+
+class M20250325T080000_Indexes : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250325T080000_Indexes)
+public:
+    explicit M20250325T080000_Indexes(Firfuorida::Migrator *parent);
+    ~M20250325T080000_Indexes() override;
+
+    void up() override;
+    void down() override;
+};
+
+#endif // M20250325T080000_INDEXES_H
+
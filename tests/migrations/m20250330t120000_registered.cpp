@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "m20250330t120000_registered.h"
+
+// registration of a class inside a namespace
+FIRFUORIDA_REGISTER_MIGRATION(registered::M20250330T120000_Registered)
+
+using namespace registered;
+
+M20250330T120000_Registered::M20250330T120000_Registered(Firfuorida::Migrator *parent) :
+    Firfuorida::Migration(parent)
+{
+
+}
+
+M20250330T120000_Registered::~M20250330T120000_Registered()
+{
+
+}
+
+void M20250330T120000_Registered::up()
+{
+    auto t = create(QStringLiteral("registered"));
+    t->increments();
+}
+
+void M20250330T120000_Registered::down()
+{
+    drop(QStringLiteral("registered"));
+}
+
+#include "moc_m20250330t120000_registered.cpp"
@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef M20250330T120000_REGISTERED_H
+#define M20250330T120000_REGISTERED_H
+
+#include <Firfuorida/migration.h>
+
+namespace registered {
+
+class M20250330T120000_Registered : public Firfuorida::Migration
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(M20250330T120000_Registered)
+public:
+    explicit M20250330T120000_Registered(Firfuorida::Migrator *parent);
+    ~M20250330T120000_Registered() override;
+
+    void up() override;
+    void down() override;
+};
+
+}
+
+#endif // M20250330T120000_REGISTERED_H
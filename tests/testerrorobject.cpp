@@ -44,6 +44,14 @@ void TestErrorObject::testConstructorWithArgs()
     QCOMPARE(e2.type(), Firfuorida::Error::SqlError);
     QCOMPARE(e2.text(), e2CompText);
     QCOMPARE(e2.sqlError(), sqlError);
+    QCOMPARE(e2.category(), Firfuorida::Error::Unclassified);
+    QVERIFY(!e2.isTransient());
+
+    Firfuorida::Error e3(sqlError, e2Text, Firfuorida::Error::Deadlock);
+    QCOMPARE(e3.type(), Firfuorida::Error::SqlError);
+    QCOMPARE(e3.category(), Firfuorida::Error::Deadlock);
+    QVERIFY(e3.isTransient());
+    QVERIFY(e3 != e2);
 }
 
 void TestErrorObject::testCompare()
@@ -17,6 +17,7 @@
 #include <QSqlQuery>
 #include <QStandardPaths>
 #include <QRegularExpression>
+#include <QDateTime>
 
 #include "migrations/m20220119t181049_tiny.h"
 #include "migrations/m20220119t181249_small.h"
@@ -27,6 +28,8 @@
 #include "migrations/m20220129t115726_foreignkey1.h"
 #include "migrations/m20220129t115731_foreignkey2.h"
 #include "migrations/m20220218t084654_drop_column.h"
+#include "migrations/m20250320t100000_partitions.h"
+#include "migrations/m20250325t080000_indexes.h"
 
 #define DB_NAME "mysqlmigtestdb"
 #define DB_USER "mysqlmigtester"
@@ -49,6 +52,9 @@ private Q_SLOTS:
     void testMigration();
     void testForeignKeys();
     void testDropColumn();
+    void testPartitions();
+    void testPartitionRotation();
+    void testIndexes();
 
 private:
     Firfuorida::Migrator *m_testmigrator = nullptr;
@@ -611,6 +617,112 @@ void TestMySqlMigrations::testDropColumn()
     QVERIFY(migrator->rollback());
 }
 
+void TestMySqlMigrations::testPartitions()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"), this);
+    new M20250320T100000_Partitions(migrator);
+    QVERIFY(migrator->migrate());
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT PARTITION_NAME FROM information_schema.PARTITIONS WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'partitioned' ORDER BY PARTITION_ORDINAL_POSITION")));
+    QStringList partitions;
+    while (q.next()) {
+        partitions << q.value(0).toString();
+    }
+    QCOMPARE(partitions, QStringList({QStringLiteral("p2024"), QStringLiteral("p2025"), QStringLiteral("pmax")}));
+
+    QVERIFY(migrator->rollback());
+}
+
+void TestMySqlMigrations::testPartitionRotation()
+{
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE rotated (id INT NOT NULL, created_at DATE NOT NULL, PRIMARY KEY (id, created_at)) "
+                                  "PARTITION BY RANGE COLUMNS (created_at) (PARTITION rotated_p200001 VALUES LESS THAN ('2000-02-01'))")));
+    // new partitions can not be added above the catch-all partition
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE rotated_max (id INT NOT NULL, created_at DATE NOT NULL, PRIMARY KEY (id, created_at)) "
+                                  "PARTITION BY RANGE COLUMNS (created_at) (PARTITION rotated_max_p200001 VALUES LESS THAN ('2000-02-01'), "
+                                  "PARTITION pmax VALUES LESS THAN (MAXVALUE))")));
+
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"), this);
+    QVERIFY(migrator->addPartitionRotation(QStringLiteral("rotated"), Firfuorida::Migrator::Monthly, 2, 3));
+    QVERIFY(migrator->addPartitionRotation(QStringLiteral("rotated_max"), Firfuorida::Migrator::Monthly, 2));
+
+    // only MariaDB 10.7 and newer can detach partitions
+    {
+        Firfuorida::Migrator detaching(QStringLiteral(DB_CONN), QStringLiteral("migrations"));
+        QVERIFY(detaching.initDatabase());
+        const bool detaches = detaching.dbType() == Firfuorida::Migrator::MariaDB && detaching.dbVersion() >= QVersionNumber(10,7);
+        QCOMPARE(detaching.addPartitionRotation(QStringLiteral("rotated"), Firfuorida::Migrator::Monthly, 2, 3, Firfuorida::Migrator::DetachExpired), detaches);
+        if (!detaches) {
+            QCOMPARE(detaching.lastError().type(), Firfuorida::Error::InternalError);
+        }
+    }
+
+    const QDate current = QDateTime::currentDateTimeUtc().date();
+    const QDate month(current.year(), current.month(), 1);
+    const QStringList expected({
+                                   QLatin1String("rotated_p") + month.toString(QStringLiteral("yyyyMM")),
+                                   QLatin1String("rotated_p") + month.addMonths(1).toString(QStringLiteral("yyyyMM")),
+                                   QLatin1String("rotated_p") + month.addMonths(2).toString(QStringLiteral("yyyyMM"))
+                               });
+
+    const QStringList expectedMax({
+                                      QStringLiteral("rotated_max_p200001"),
+                                      QLatin1String("rotated_max_p") + month.toString(QStringLiteral("yyyyMM")),
+                                      QLatin1String("rotated_max_p") + month.addMonths(1).toString(QStringLiteral("yyyyMM")),
+                                      QLatin1String("rotated_max_p") + month.addMonths(2).toString(QStringLiteral("yyyyMM")),
+                                      QStringLiteral("pmax")
+                                  });
+
+    const QString partitionsQuery = QStringLiteral("SELECT PARTITION_NAME FROM information_schema.PARTITIONS WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '%1' ORDER BY PARTITION_ORDINAL_POSITION");
+
+    // the second run has nothing to do
+    for (int run = 0; run < 2; ++run) {
+        QVERIFY(migrator->rotatePartitions());
+        QVERIFY(q.exec(partitionsQuery.arg(QStringLiteral("rotated"))));
+        QStringList partitions;
+        while (q.next()) {
+            partitions << q.value(0).toString();
+        }
+        QCOMPARE(partitions, expected);
+
+        QVERIFY(q.exec(partitionsQuery.arg(QStringLiteral("rotated_max"))));
+        partitions.clear();
+        while (q.next()) {
+            partitions << q.value(0).toString();
+        }
+        QCOMPARE(partitions, expectedMax);
+    }
+
+    QVERIFY(q.exec(QStringLiteral("DROP TABLE rotated")));
+    QVERIFY(q.exec(QStringLiteral("DROP TABLE rotated_max")));
+}
+
+void TestMySqlMigrations::testIndexes()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"), this);
+    new M20250325T080000_Indexes(migrator);
+    QVERIFY(migrator->migrate());
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT INDEX_NAME, COLUMN_NAME, INDEX_TYPE, SUB_PART FROM information_schema.STATISTICS "
+                                  "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'indexed' AND INDEX_NAME != 'PRIMARY' "
+                                  "ORDER BY INDEX_NAME, SEQ_IN_INDEX")));
+    QStringList indexes;
+    while (q.next()) {
+        indexes << q.value(0).toString() + QLatin1Char('|') + q.value(1).toString() + QLatin1Char('|') + q.value(2).toString() + QLatin1Char('|') + q.value(3).toString();
+    }
+    QCOMPARE(indexes, QStringList({
+                                      QStringLiteral("title_body_fulltext|title|FULLTEXT|"),
+                                      QStringLiteral("title_body_fulltext|body|FULLTEXT|"),
+                                      QStringLiteral("title_prefix|title|BTREE|32"),
+                                      QStringLiteral("title_prefix|id|BTREE|")
+                                  }));
+
+    QVERIFY(migrator->rollback());
+}
+
 QTEST_MAIN(TestMySqlMigrations)
 
 #include "testmysqlmigrations.moc"
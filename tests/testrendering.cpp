@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "../Firfuorida/migrator_p.h"
+#include "../Firfuorida/migration.h"
+#include "../Firfuorida/table_p.h"
+#include "../Firfuorida/dialect_p.h"
+#include "../Firfuorida/sqlbuilder_p.h"
+#include <QObject>
+#include <QTest>
+#include <QVersionNumber>
+#include <QDate>
+
+using namespace Firfuorida;
+
+class RenderMigration : public Migration
+{
+    Q_OBJECT
+public:
+    explicit RenderMigration(Migrator *parent) : Migration(parent) {}
+    ~RenderMigration() override = default;
+
+    Table *createTable(const QString &tableName) { return create(tableName); }
+    Table *alterTable(const QString &tableName) { return table(tableName); }
+
+protected:
+    void up() override {}
+    void down() override {}
+};
+
+class TestRendering : public QObject
+{
+    Q_OBJECT
+public:
+    TestRendering(QObject *parent = nullptr) : QObject(parent) {}
+    ~TestRendering() override = default;
+
+private Q_SLOTS:
+    void testIncrements_data();
+    void testIncrements();
+    void testHashPartitions();
+    void testReorganizePartition();
+    void testModifyColumnDefaults();
+    void testSqliteAlterChanges();
+
+private:
+    Migrator *createMigrator(Migrator::DatabaseType dbType, const QVersionNumber &dbVersion);
+};
+
+Migrator *TestRendering::createMigrator(Migrator::DatabaseType dbType, const QVersionNumber &dbVersion)
+{
+    auto migrator = new Migrator(QStringLiteral("testrendering"), QStringLiteral("migrations"), this);
+    auto d = MigratorPrivate::get(migrator);
+    d->context.type = dbType;
+    d->context.version = dbVersion;
+    d->setDbFeatures();
+    return migrator;
+}
+
+void TestRendering::testIncrements_data()
+{
+    QTest::addColumn<Migrator::DatabaseType>("dbType");
+    QTest::addColumn<QVersionNumber>("dbVersion");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("MySQL") << Migrator::MySQL << QVersionNumber(8,0,30) << QStringLiteral("CREATE TABLE items(id INT UNSIGNED PRIMARY KEY AUTO_INCREMENT NOT NULL)");
+    // SQLite only accepts AUTOINCREMENT on columns declared exactly as INTEGER PRIMARY KEY
+    QTest::newRow("SQLite") << Migrator::SQLite << QVersionNumber(3,38,0) << QStringLiteral("CREATE TABLE items(id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL)");
+}
+
+void TestRendering::testIncrements()
+{
+    QFETCH(Migrator::DatabaseType, dbType);
+    QFETCH(QVersionNumber, dbVersion);
+    QFETCH(QString, expected);
+
+    Migrator *migrator = createMigrator(dbType, dbVersion);
+    auto migration = new RenderMigration(migrator);
+    Table *t = migration->createTable(QStringLiteral("items"));
+    t->increments();
+
+    QCOMPARE(TablePrivate::get(t)->queryString(), expected);
+
+    delete migrator;
+}
+
+void TestRendering::testHashPartitions()
+{
+    Migrator *migrator = createMigrator(Migrator::PSQL, QVersionNumber(14,0));
+    auto migration = new RenderMigration(migrator);
+    Table *t = migration->createTable(QStringLiteral("events"));
+    t->integer(QStringLiteral("id"));
+    t->partitionByHash(QStringLiteral("id"), 2);
+
+    // every partition is a table of its own on PostgreSQL
+    const QList<Table *> tables = migration->findChildren<Table *>(QString(), Qt::FindDirectChildrenOnly);
+    QCOMPARE(static_cast<int>(tables.size()), 3);
+    QCOMPARE(TablePrivate::get(tables.at(0))->queryString(), QStringLiteral("CREATE TABLE events(id INTEGER NOT NULL) PARTITION BY HASH (id)"));
+    QCOMPARE(TablePrivate::get(tables.at(1))->queryString(), QStringLiteral("CREATE TABLE events_p0 PARTITION OF events FOR VALUES WITH (MODULUS 2, REMAINDER 0)"));
+    QCOMPARE(TablePrivate::get(tables.at(2))->queryString(), QStringLiteral("CREATE TABLE events_p1 PARTITION OF events FOR VALUES WITH (MODULUS 2, REMAINDER 1)"));
+
+    delete migrator;
+}
+
+void TestRendering::testReorganizePartition()
+{
+    Migrator *migrator = createMigrator(Migrator::MySQL, QVersionNumber(8,0,30));
+    auto migration = new RenderMigration(migrator);
+    Table *t = migration->alterTable(QStringLiteral("events"));
+
+    // new partitions are split off from the catch-all partition
+    PartitionPrivate p;
+    p.name = QStringLiteral("events_p202503");
+    p.from = QDate(2025,3,1);
+    p.to = QDate(2025,4,1);
+    p.reorganize = QStringLiteral("pmax");
+    TablePrivate::get(t)->addPartition(std::move(p));
+
+    const QList<Table *> tables = migration->findChildren<Table *>(QString(), Qt::FindDirectChildrenOnly);
+    QCOMPARE(static_cast<int>(tables.size()), 2);
+    QCOMPARE(TablePrivate::get(tables.at(1))->queryString(), QStringLiteral("ALTER TABLE events REORGANIZE PARTITION pmax INTO (PARTITION events_p202503 VALUES LESS THAN ('2025-04-01'), PARTITION pmax VALUES LESS THAN (MAXVALUE))"));
+
+    delete migrator;
+}
+
+void TestRendering::testModifyColumnDefaults()
+{
+    Migrator *migrator = createMigrator(Migrator::PSQL, QVersionNumber(14,0));
+    auto migration = new RenderMigration(migrator);
+
+    // the default can not be rendered, so it is not touched
+    Table *t = migration->alterTable(QStringLiteral("items"));
+    t->integer(QStringLiteral("amount"))->defaultValue(5)->change();
+    QCOMPARE(TablePrivate::get(t)->queryString(), QStringLiteral("ALTER TABLE items ALTER COLUMN amount TYPE INTEGER, ALTER COLUMN amount SET NOT NULL"));
+
+    // only a column without default drops it
+    Table *t2 = migration->alterTable(QStringLiteral("notes"));
+    t2->text(QStringLiteral("note"))->nullable()->change();
+    QCOMPARE(TablePrivate::get(t2)->queryString(), QStringLiteral("ALTER TABLE notes ALTER COLUMN note TYPE TEXT, ALTER COLUMN note DROP NOT NULL, ALTER COLUMN note DROP DEFAULT"));
+
+    delete migrator;
+}
+
+void TestRendering::testSqliteAlterChanges()
+{
+    const Dialect *dialect = Dialect::forType(Migrator::SQLite);
+    Error error;
+
+    // SQLite can not add indexes with ALTER TABLE
+    ColumnPrivate key;
+    key.type = ColumnPrivate::UniqueKey;
+    key.operation = ColumnPrivate::AddColumn;
+    key.constraintCols = QStringList({QStringLiteral("a"), QStringLiteral("b")});
+    QVERIFY(dialect->altersIndexesSeparately());
+    QVERIFY(dialect->checkAlterChange(QStringLiteral("items"), key, error));
+    SqlBuilder create(dialect);
+    dialect->renderCreateIndex(create, QStringLiteral("items"), key);
+    QCOMPARE(create.take(), QStringLiteral("CREATE UNIQUE INDEX items_a_b_key ON items (a,b)"));
+
+    key.type = ColumnPrivate::Key;
+    key.operation = ColumnPrivate::DropColumn;
+    key.indexName = QStringLiteral("items_idx");
+    QVERIFY(dialect->checkAlterChange(QStringLiteral("items"), key, error));
+    SqlBuilder drop(dialect);
+    dialect->renderDropIndex(drop, key);
+    QCOMPARE(drop.take(), QStringLiteral("DROP INDEX items_idx"));
+
+    // everything else can only be changed by recreating the table
+    key.type = ColumnPrivate::ForeignKey;
+    key.operation = ColumnPrivate::AddColumn;
+    QVERIFY(!dialect->checkAlterChange(QStringLiteral("items"), key, error));
+    QCOMPARE(error.type(), Error::InternalError);
+
+    ColumnPrivate col;
+    col.name = QStringLiteral("amount");
+    col.type = ColumnPrivate::Int;
+    col.operation = ColumnPrivate::ModifyColumn;
+    QVERIFY(!dialect->checkAlterChange(QStringLiteral("items"), col, error));
+    QVERIFY(error.text().contains(QStringLiteral("amount")));
+
+    QVERIFY(Dialect::forType(Migrator::PSQL)->checkAlterChange(QStringLiteral("items"), col, error));
+}
+
+QTEST_MAIN(TestRendering)
+
+#include "testrendering.moc"
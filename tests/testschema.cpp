@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2019-2025 Matthias Fehring <https://www.huessenbergnetz.de>
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "../Firfuorida/migrator_p.h"
+#include "../Firfuorida/schema_p.h"
+#include <QObject>
+#include <QTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+using namespace Firfuorida;
+
+#define DB_CONN "testschema"
+
+class TestSchema : public QObject
+{
+    Q_OBJECT
+public:
+    TestSchema(QObject *parent = nullptr) : QObject(parent) {}
+    ~TestSchema() override = default;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testSqliteSchema();
+};
+
+void TestSchema::initTestCase()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral(DB_CONN));
+    db.setDatabaseName(QStringLiteral(":memory:"));
+    QVERIFY2(db.open(), qUtf8Printable(db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY2(q.exec(QStringLiteral("CREATE TABLE authors (id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL, name TEXT NOT NULL DEFAULT 'anon''s', born TEXT)")), qUtf8Printable(q.lastError().text()));
+    QVERIFY2(q.exec(QStringLiteral("CREATE UNIQUE INDEX authors_name_idx ON authors (name)")), qUtf8Printable(q.lastError().text()));
+    QVERIFY2(q.exec(QStringLiteral("CREATE TABLE books (author_id INTEGER NOT NULL, isbn TEXT NOT NULL, pages INTEGER DEFAULT 42, "
+                                   "PRIMARY KEY (author_id, isbn), "
+                                   "FOREIGN KEY (author_id) REFERENCES authors (id) ON DELETE CASCADE)")), qUtf8Printable(q.lastError().text()));
+}
+
+void TestSchema::cleanupTestCase()
+{
+    QSqlDatabase::database(QStringLiteral(DB_CONN)).close();
+    QSqlDatabase::removeDatabase(QStringLiteral(DB_CONN));
+}
+
+void TestSchema::testSqliteSchema()
+{
+    Migrator migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"));
+    QVERIFY(migrator.initDatabase());
+    if (migrator.dbVersion() < QVersionNumber(3, 16, 0)) {
+        QSKIP("Reading the schema requires SQLite 3.16.0 or newer");
+    }
+
+    auto d = MigratorPrivate::get(&migrator);
+    Schema schema(d->context);
+    QVERIFY(d->loadSchema(schema));
+
+    // internal tables like sqlite_sequence are not part of the schema
+    QCOMPARE(static_cast<int>(schema.tables.size()), 2);
+
+    const SchemaTable *authors = schema.table(QStringLiteral("authors"));
+    QVERIFY(authors);
+
+    const ColumnPrivate *id = authors->column(QStringLiteral("id"));
+    QVERIFY(id);
+    QCOMPARE(id->type, ColumnPrivate::Int);
+    QVERIFY(id->_autoIncrement);
+    QVERIFY(!id->_nullable);
+
+    const ColumnPrivate *name = authors->column(QStringLiteral("name"));
+    QVERIFY(name);
+    QCOMPARE(name->type, ColumnPrivate::Text);
+    QVERIFY(!name->_nullable);
+    QCOMPARE(name->defVal.toString(), QStringLiteral("anon's"));
+
+    const ColumnPrivate *born = authors->column(QStringLiteral("born"));
+    QVERIFY(born);
+    QVERIFY(born->_nullable);
+    QVERIFY(!born->defVal.isValid());
+
+    // the auto increment column carries the primary key inline, the named index follows the data columns
+    QCOMPARE(static_cast<int>(authors->columns.size()), 4);
+    const ColumnPrivate &nameIdx = authors->columns.back();
+    QCOMPARE(nameIdx.type, ColumnPrivate::UniqueKey);
+    QCOMPARE(nameIdx.indexName, QStringLiteral("authors_name_idx"));
+    QCOMPARE(nameIdx.constraintCols, QStringList({QStringLiteral("name")}));
+
+    const SchemaTable *books = schema.table(QStringLiteral("books"));
+    QVERIFY(books);
+
+    const ColumnPrivate *pages = books->column(QStringLiteral("pages"));
+    QVERIFY(pages);
+    QCOMPARE(pages->defVal.toString(), QStringLiteral("42"));
+
+    const ColumnPrivate *pk = nullptr;
+    const ColumnPrivate *fk = nullptr;
+    for (const ColumnPrivate &c : books->columns) {
+        if (c.type == ColumnPrivate::PrimaryKey) {
+            pk = &c;
+        } else if (c.type == ColumnPrivate::ForeignKey) {
+            fk = &c;
+        }
+    }
+
+    QVERIFY(pk);
+    QCOMPARE(pk->constraintCols, QStringList({QStringLiteral("author_id"), QStringLiteral("isbn")}));
+
+    QVERIFY(fk);
+    QCOMPARE(fk->constraintCols, QStringList({QStringLiteral("author_id")}));
+    QCOMPARE(fk->referenceTable, QStringLiteral("authors"));
+    QCOMPARE(fk->referenceCols, QStringList({QStringLiteral("id")}));
+    QCOMPARE(fk->onDelete, QStringLiteral("CASCADE"));
+    QVERIFY(fk->onUpdate.isEmpty());
+}
+
+QTEST_MAIN(TestSchema)
+
+#include "testschema.moc"
@@ -17,6 +17,8 @@
 #include <QStandardPaths>
 #include <QRegularExpression>
 #include <QSqlDriver>
+#include <atomic>
+#include <memory>
 
 #include "migrations/m20220119t181049_tiny.h"
 #include "migrations/m20220119t181249_small.h"
@@ -27,6 +29,9 @@
 #include "migrations/m20220129t115726_foreignkey1.h"
 #include "migrations/m20220129t115731_foreignkey2.h"
 #include "migrations/m20220218t084654_drop_column.h"
+#include "migrations/m20250301t120000_backfill.h"
+#include "migrations/m20250315t090000_steps.h"
+#include "migrations/m20250316t090000_fixed.h"
 
 #define DB_CONN "sqlitemigtests"
 
@@ -46,6 +51,22 @@ private Q_SLOTS:
     void testMigration();
     void testForeignKeys();
     void testDropColumn();
+    void testRegisteredMigrations();
+    void testMigrationRegistry();
+    void testBaseline();
+    void testDiff();
+    void testChecksums();
+    void testRollbackBatch();
+    void testTargetedMigrations();
+    void testPhases();
+    void testBackgroundMigrations();
+    void testLagProbe();
+    void testLagProbeFailure();
+    void testLockTimeout();
+    void testCancellation();
+    void testResumeMigration();
+    void testResumeFixedMigration();
+    void testLegacyMigrationsTable();
 
 private:
     Firfuorida::Migrator *m_testmigrator = nullptr;
@@ -277,6 +298,428 @@ void TestSqliteMigrations::testDropColumn()
     QVERIFY(migrator->rollback());
 }
 
+void TestSqliteMigrations::testRegisteredMigrations()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("registered_migrations"), this);
+    migrator->addMigration<M20220218T084654_Drop_column>();
+    migrator->addMigration<M20220218T084654_Drop_column>();
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->findChildren<Firfuorida::Migration *>().empty());
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->rollback());
+    QVERIFY(migrator->findChildren<Firfuorida::Migration *>().empty());
+}
+
+void TestSqliteMigrations::testMigrationRegistry()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("registry_migrations"), this);
+    migrator->addRegisteredMigrations();
+    migrator->addRegisteredMigrations();
+    QVERIFY(migrator->findChildren<Firfuorida::Migration *>().empty());
+    QVERIFY(migrator->migrate());
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+    QVERIFY(tableExists(QStringLiteral("registered")));
+
+    // registered migrations store the checksum of their source file next to the one of their SQL
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT checksum, source_checksum FROM registry_migrations WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toString().size(), 32);
+    QVERIFY(q.value(0).toString() != QStringLiteral(DROP_COLUMN_CHECKSUM));
+    QCOMPARE(q.value(1).toString(), QStringLiteral(DROP_COLUMN_CHECKSUM));
+    QVERIFY(migrator->verifyChecksums());
+
+    // applied before the source was checksummed or with an edit that does not change the SQL
+    QVERIFY(q.exec(QStringLiteral("UPDATE registry_migrations SET source_checksum = NULL WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(migrator->verifyChecksums());
+    QVERIFY(q.exec(QStringLiteral("UPDATE registry_migrations SET source_checksum = 'd41d8cd98f00b204e9800998ecf8427e' WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(migrator->verifyChecksums());
+
+    // the SQL is compared as soon as the source file differs
+    QVERIFY(q.exec(QStringLiteral("UPDATE registry_migrations SET checksum = 'd41d8cd98f00b204e9800998ecf8427e' WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(!migrator->verifyChecksums());
+
+    QVERIFY(migrator->rollback(2));
+    QVERIFY(!tableExists(QStringLiteral("registered")));
+}
+
+void TestSqliteMigrations::testBaseline()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("baseline_migrations"), this);
+    migrator->addMigration<M20220218T084654_Drop_column>();
+    // the migration itself serves as squashed schema of everything up to itself
+    migrator->setBaseline<M20220218T084654_Drop_column>(QStringLiteral("M20220218T084654_Drop_column"));
+    QVERIFY(migrator->migrate());
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT migration FROM baseline_migrations")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toString(), QStringLiteral("M20220218T084654_Drop_column"));
+    QVERIFY(!q.next());
+
+    // already applied, so the baseline is not applied again
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testDiff()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"), this);
+    QVERIFY(migrator->diff<M20220119t181049_Tiny>().empty());
+    QCOMPARE(migrator->lastError().type(), Firfuorida::Error::NoError);
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("ALTER TABLE tiny ADD COLUMN drift INTEGER")));
+    const QStringList statements = migrator->diff<M20220119t181049_Tiny>();
+    QCOMPARE(statements.size(), 1);
+    QCOMPARE(statements.first(), QStringLiteral("ALTER TABLE tiny DROP COLUMN drift"));
+
+    if (migrator->dbVersion() < QVersionNumber(3, 35, 0)) {
+        QSKIP("SQLite below version 3.35.0 does not support ALTER TABLE DROP COLUMN");
+    }
+    QVERIFY(migrator->converge<M20220119t181049_Tiny>());
+    QVERIFY(migrator->diff<M20220119t181049_Tiny>().empty());
+
+    // indexes are dropped by a statement of their own
+    QVERIFY(q.exec(QStringLiteral("CREATE INDEX tiny_drift_idx ON tiny (tinyTextCol)")));
+    QCOMPARE(migrator->diff<M20220119t181049_Tiny>(), QStringList({QStringLiteral("DROP INDEX tiny_drift_idx")}));
+    QVERIFY(migrator->converge<M20220119t181049_Tiny>());
+    QVERIFY(migrator->diff<M20220119t181049_Tiny>().empty());
+}
+
+void TestSqliteMigrations::testChecksums()
+{
+    QVERIFY(m_testmigrator->verifyChecksums());
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT checksum, batch FROM migrations WHERE migration = 'M20220119T181249_Small'")));
+    QVERIFY(q.next());
+    const QString checksum = q.value(0).toString();
+    QCOMPARE(checksum.size(), 32);
+    QVERIFY(q.value(1).toInt() > 0);
+
+    QVERIFY(q.exec(QStringLiteral("UPDATE migrations SET checksum = '00000000000000000000000000000000' WHERE migration = 'M20220119T181249_Small'")));
+    QVERIFY(!m_testmigrator->verifyChecksums());
+    QVERIFY(m_testmigrator->lastError().text().contains(QStringLiteral("M20220119T181249_Small")));
+
+    QVERIFY(q.exec(QStringLiteral("UPDATE migrations SET checksum = '%1' WHERE migration = 'M20220119T181249_Small'").arg(checksum)));
+    QVERIFY(m_testmigrator->verifyChecksums());
+}
+
+void TestSqliteMigrations::testRollbackBatch()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("batch_migrations"), this);
+    migrator->addMigration<M20220218T084654_Drop_column>();
+    QVERIFY(migrator->rollbackBatch());
+    QVERIFY(migrator->migrate());
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+
+    QVERIFY(migrator->rollbackBatch());
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM batch_migrations")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+}
+
+void TestSqliteMigrations::testTargetedMigrations()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("migrations"), this);
+    migrator->addMigration<M20220129T115726_Foreignkey1>();
+    migrator->addMigration<M20220129T115731_Foreignkey2>();
+    migrator->addMigration<M20220218T084654_Drop_column>();
+
+    QVERIFY(!migrator->migrateTo(QStringLiteral("M20220101T000000_Unknown")));
+
+    QVERIFY(migrator->rollbackTo(QStringLiteral("M20220129T115726_Foreignkey1")));
+    QVERIFY(tableExists(QStringLiteral("table1")));
+    QVERIFY(!tableExists(QStringLiteral("table2")));
+
+    QVERIFY(migrator->migrateTo(QStringLiteral("M20220129T115731_Foreignkey2")));
+    QVERIFY(tableExists(QStringLiteral("table2")));
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM migrations WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+}
+
+void TestSqliteMigrations::testPhases()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("phase_migrations"), this);
+    migrator->addMigration<M20220218T084654_Drop_column>();
+
+    QVERIFY(migrator->migrate(Firfuorida::Migrator::PostDeploy));
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM phase_migrations")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+
+    QVERIFY(migrator->migrate(Firfuorida::Migrator::PreDeploy));
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+    QVERIFY(q.exec(QStringLiteral("SELECT phase FROM phase_migrations WHERE migration = 'M20220218T084654_Drop_column'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), static_cast<int>(Firfuorida::Migrator::PreDeploy));
+
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testBackgroundMigrations()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("background_migrations"), this);
+    migrator->addMigration<M20250301T120000_Backfill>();
+    migrator->setBackgroundThrottle(1);
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->waitForBackgroundMigrations(10000));
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT progress, phase FROM background_migrations WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(q.next());
+    QVERIFY(q.value(0).isNull());
+    QCOMPARE(q.value(1).toInt(), static_cast<int>(Firfuorida::Migrator::Background));
+    QVERIFY(q.exec(QStringLiteral("SELECT name FROM %1 WHERE type = 'index' AND name = 'tiny_text_idx'").arg(sqliteSchemaName)));
+    QVERIFY(q.next());
+
+    // simulate a restart after the first statement, creating the index again would fail
+    QVERIFY(q.exec(QStringLiteral("UPDATE background_migrations SET progress = 1 WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->waitForBackgroundMigrations(10000));
+    QVERIFY(q.exec(QStringLiteral("SELECT progress FROM background_migrations WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(q.next());
+    QVERIFY(q.value(0).isNull());
+
+    // a failed background migration is reported and not rolled back before it has finished
+    QVERIFY(q.exec(QStringLiteral("UPDATE background_migrations SET progress = 0 WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(migrator->migrate());
+    QVERIFY(!migrator->waitForBackgroundMigrations(10000));
+    QVERIFY(migrator->lastError().text().contains(QStringLiteral("M20250301T120000_Backfill")));
+    QVERIFY(migrator->rollback());
+    QVERIFY(q.exec(QStringLiteral("SELECT name FROM %1 WHERE type = 'index' AND name = 'tiny_text_idx'").arg(sqliteSchemaName)));
+    QVERIFY(q.next());
+
+    QVERIFY(q.exec(QStringLiteral("UPDATE background_migrations SET progress = 1 WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->waitForBackgroundMigrations(10000));
+
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testLagProbe()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("lag_migrations"), this);
+    migrator->addMigration<M20250301T120000_Backfill>();
+
+    // the background worker calls the probe from its own thread
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    migrator->setLagProbe([calls](const QSqlDatabase &db) -> qint64 {
+        Q_UNUSED(db)
+        return calls->fetch_add(1) == 0 ? 5000 : 0;
+    }, 1000, 10);
+
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->waitForBackgroundMigrations(10000));
+    QVERIFY(calls->load() >= 2);
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT lag_wait FROM lag_migrations WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(q.next());
+    QVERIFY(q.value(0).toLongLong() > 0);
+
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testLagProbeFailure()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("lag_failure_migrations"), this);
+    migrator->addMigration<M20250301T120000_Backfill>();
+
+    // a failed measurement pauses the migration until the lag is known again
+    auto calls = std::make_shared<std::atomic<int>>(0);
+    migrator->setLagProbe([calls](const QSqlDatabase &db) -> qint64 {
+        Q_UNUSED(db)
+        return calls->fetch_add(1) < 2 ? -1 : 0;
+    }, 1000, 10);
+
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->waitForBackgroundMigrations(10000));
+    QVERIFY(calls->load() >= 3);
+
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("SELECT lag_wait FROM lag_failure_migrations WHERE migration = 'M20250301T120000_Backfill'")));
+    QVERIFY(q.next());
+    QVERIFY(q.value(0).toLongLong() > 0);
+
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testLockTimeout()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("lock_migrations"), this);
+    migrator->addMigration<M20220218T084654_Drop_column>();
+    // creates the migrations table without applying anything
+    QVERIFY(migrator->migrate(Firfuorida::Migrator::PostDeploy));
+
+    migrator->setLockTimeout(50);
+    migrator->setRetries(2, 10);
+
+    // the timeout of the session is restored after every migration
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+    QVERIFY(q.exec(QStringLiteral("PRAGMA busy_timeout = 1234")));
+
+    const QString lockerConn = QStringLiteral(DB_CONN) + QStringLiteral("-locker");
+    {
+        QSqlDatabase locker = QSqlDatabase::cloneDatabase(QSqlDatabase::database(QStringLiteral(DB_CONN)), lockerConn);
+        QVERIFY(locker.open());
+        QSqlQuery lq(locker);
+        // readers are still allowed, writers have to wait
+        QVERIFY(lq.exec(QStringLiteral("BEGIN IMMEDIATE")));
+
+        QVERIFY(!migrator->migrate());
+        QCOMPARE(migrator->lastError().type(), Firfuorida::Error::SqlError);
+        QCOMPARE(migrator->lastError().category(), Firfuorida::Error::LockTimeout);
+        QVERIFY(migrator->lastError().isTransient());
+
+        QVERIFY(lq.exec(QStringLiteral("COMMIT")));
+        locker.close();
+    }
+    QSqlDatabase::removeDatabase(lockerConn);
+
+    QVERIFY(migrator->migrate());
+    QVERIFY(checkColumn(QStringLiteral("tiny"), QStringLiteral("colToDrop"), QStringLiteral("integer"), TestMigrations::NoOptions));
+    QVERIFY(q.exec(QStringLiteral("PRAGMA busy_timeout")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1234);
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testCancellation()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("cancel_migrations"), this);
+    migrator->addMigration<M20250315T090000_Steps>();
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+
+    // the lag probe keeps the migration waiting after its first statement until it times out
+    migrator->setLagProbe([](const QSqlDatabase &db) -> qint64 {
+        Q_UNUSED(db)
+        return 5000;
+    }, 1000, 10);
+    migrator->setMigrationTimeout(100);
+
+    QVERIFY(!migrator->migrate());
+    QCOMPARE(migrator->lastError().category(), Firfuorida::Error::Cancelled);
+    QVERIFY(!migrator->lastError().isTransient());
+    QVERIFY(migrator->lastError().text().contains(QLatin1String("timed out before statement 2 of 3")));
+
+    QVERIFY(q.exec(QStringLiteral("SELECT progress FROM cancel_migrations WHERE migration = 'M20250315T090000_Steps'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1);
+
+    // cancel() is thread-safe, so it can also be called from the probe
+    migrator->setMigrationTimeout(0);
+    migrator->setLagProbe([migrator](const QSqlDatabase &db) -> qint64 {
+        Q_UNUSED(db)
+        migrator->cancel();
+        return 5000;
+    }, 1000, 10);
+
+    // resumes at the second statement, the probe is called before the third one
+    QVERIFY(!migrator->migrate());
+    QCOMPARE(migrator->lastError().category(), Firfuorida::Error::Cancelled);
+    QVERIFY(migrator->lastError().text().contains(QLatin1String("has been cancelled before statement 3 of 3")));
+
+    // a cancel() before the run has started is not lost, it ends with the cancelled run
+    migrator->setLagProbe(Firfuorida::Migrator::LagProbe(), 0);
+    migrator->cancel();
+    QVERIFY(!migrator->migrate());
+    QCOMPARE(migrator->lastError().category(), Firfuorida::Error::Cancelled);
+    QVERIFY(migrator->lastError().text().contains(QLatin1String("has been cancelled before statement 3 of 3")));
+
+    QVERIFY(migrator->migrate());
+    QVERIFY(migrator->rollback());
+}
+
+void TestSqliteMigrations::testResumeMigration()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("resume_migrations"), this);
+    migrator->addMigration<M20250315T090000_Steps>();
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+
+    // lets the second statement fail
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE steps2 (id INTEGER)")));
+    QVERIFY(!migrator->migrate());
+    QCOMPARE(migrator->lastError().category(), Firfuorida::Error::DuplicateObject);
+
+    QVERIFY(q.exec(QStringLiteral("SELECT progress, batch FROM resume_migrations WHERE migration = 'M20250315T090000_Steps'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1);
+    QVERIFY(q.value(1).isNull());
+
+    // a partially applied migration is not rolled back
+    QVERIFY(migrator->rollback());
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM steps1")));
+
+    // resumes at the failed statement, creating steps1 again would fail
+    QVERIFY(q.exec(QStringLiteral("DROP TABLE steps2")));
+    QVERIFY(migrator->migrate());
+
+    QVERIFY(q.exec(QStringLiteral("SELECT progress, batch FROM resume_migrations WHERE migration = 'M20250315T090000_Steps'")));
+    QVERIFY(q.next());
+    QVERIFY(q.value(0).isNull());
+    QCOMPARE(q.value(1).toInt(), 1);
+
+    QVERIFY(migrator->rollback());
+    QVERIFY(!q.exec(QStringLiteral("SELECT COUNT(*) FROM steps1")));
+}
+
+void TestSqliteMigrations::testResumeFixedMigration()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("fixed_migrations"), this);
+    migrator->addMigration<M20250316T090000_Fixed>();
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+
+    M20250316T090000_Fixed::revision = 0;
+    QVERIFY(!migrator->migrate());
+    QVERIFY(q.exec(QStringLiteral("SELECT progress FROM fixed_migrations WHERE migration = 'M20250316T090000_Fixed'")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 1);
+
+    // changing an applied statement prevents resuming
+    M20250316T090000_Fixed::revision = 2;
+    QVERIFY(!migrator->migrate());
+    QVERIFY(migrator->lastError().text().contains(QStringLiteral("can not be resumed")));
+
+    // fixing the failed statement does not
+    M20250316T090000_Fixed::revision = 1;
+    QVERIFY(migrator->migrate());
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM fixed2")));
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM fixed3")));
+    QVERIFY(migrator->verifyChecksums());
+
+    QVERIFY(migrator->rollback());
+    QVERIFY(!q.exec(QStringLiteral("SELECT COUNT(*) FROM fixed1")));
+}
+
+void TestSqliteMigrations::testLegacyMigrationsTable()
+{
+    auto migrator = new Firfuorida::Migrator(QStringLiteral(DB_CONN), QStringLiteral("legacy_migrations"), this);
+    migrator->addMigration<M20250315T090000_Steps>();
+    QSqlQuery q(QSqlDatabase::database(QStringLiteral(DB_CONN)));
+
+    // migrations table as created before the bookkeeping columns have been added
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE legacy_migrations (migration TEXT NOT NULL UNIQUE, applied NUMERIC DEFAULT CURRENT_TIMESTAMP)")));
+    QVERIFY(q.exec(QStringLiteral("INSERT INTO legacy_migrations (migration) VALUES ('M20250315T090000_Steps')")));
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE steps1 (id INTEGER)")));
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE steps2 (id INTEGER)")));
+    QVERIFY(q.exec(QStringLiteral("CREATE TABLE steps3 (id INTEGER)")));
+
+    QVERIFY(migrator->rollbackTo(QStringLiteral("M20250315T090000_Steps")));
+    QVERIFY(q.exec(QStringLiteral("SELECT COUNT(*) FROM steps1")));
+    QVERIFY(q.exec(QStringLiteral("SELECT progress FROM legacy_migrations")));
+
+    QVERIFY(migrator->rollback());
+    QVERIFY(!q.exec(QStringLiteral("SELECT COUNT(*) FROM steps1")));
+}
+
 QTEST_MAIN(TestSqliteMigrations)
 
 #include "testsqlitemigrations.moc"